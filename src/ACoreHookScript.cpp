@@ -6,45 +6,97 @@
 
 #include "ACoreHookScript.h"
 #include "BotAI.h"
+#include "BotConfig.h"
+#include "BotManaTable.h"
+#include "BotMapData.h"
+#include "BotPartyStats.h"
+#include "BotSelfCheck.h"
+#include "BotTraffic.h"
 #include "BotMgr.h"
 #include "Creature.h"
 #include "MapMgr.h"
 #include "Player.h"
 #include "Spell.h"
+#include "SpellAuras.h"
+#include "SpellInfo.h"
+#include "StringFormat.h"
 #include "Transport.h"
 
 /////////////////////////////////
 // Azeroth core hook scripts here
 /////////////////////////////////
 
-void PlayerHookScript::OnLogin(Player* player)
+void UnitHookScript::OnAuraApply(Unit* unit, Aura* aura)
 {
-    ChatHandler(player->GetSession()).SendSysMessage("This server is running npcbots module...");
+    if (aura)
+    {
+        InvalidateBotAuraCaches(unit, aura->GetSpellInfo());
+    }
+}
 
-    if (strcmp(player->GetName().c_str(), "Felthas") == 0)
+void UnitHookScript::OnAuraRemove(Unit* unit, AuraApplication* aurApp, AuraRemoveMode /*mode*/)
+{
+    if (aurApp)
     {
-        player->SetDisplayId(27545);
+        InvalidateBotAuraCaches(unit, aurApp->GetBase()->GetSpellInfo());
     }
 }
 
-void PlayerHookScript::OnLogout(Player* player)
+void UnitHookScript::InvalidateBotAuraCaches(Unit* unit, SpellInfo const* spellInfo)
 {
-    BotEntryMap botsMap = sBotsRegistry->GetEntryByOwnerGUID(player->GetGUID());
+    if (!unit || !spellInfo)
+    {
+        return;
+    }
+
+    Creature* creature = unit->ToCreature();
 
-    if (!botsMap.empty())
+    if (!creature || creature->GetEntry() <= BOT_ENTRY_BASE)
     {
-        for (BotEntryMap::iterator itr = botsMap.begin(); itr != botsMap.end(); ++itr)
+        return;
+    }
+
+    BotAI* ai = BotMgr::GetBotAI(creature);
+
+    if (!ai)
+    {
+        return;
+    }
+
+    for (uint8 i = 0; i != MAX_SPELL_EFFECTS; ++i)
+    {
+        uint32 const auraname = spellInfo->Effects[i].ApplyAuraName;
+
+        if (BotAI::IsStatAura(auraname))
         {
-            BotEntry* entry = itr->second;
+            ai->InvalidateStatCache();
+        }
 
-            if (entry)
-            {
-                BotMgr::DismissBot(entry->GetBot());
-            }
+        if (BotAI::IsRegenAura(auraname))
+        {
+            ai->InvalidateRegenAuraCache();
         }
     }
 }
 
+void PlayerHookScript::OnLogin(Player* player)
+{
+    ChatHandler(player->GetSession()).SendSysMessage("This server is running npcbots module...");
+
+    if (strcmp(player->GetName().c_str(), "Felthas") == 0)
+    {
+        player->SetDisplayId(27545);
+    }
+}
+
+void PlayerHookScript::OnLogout(Player* player)
+{
+    sBotsRegistry->ForEachBotOfOwner(player->GetGUID(), [](BotEntry const& entry)
+    {
+        BotMgr::DismissBot(entry.GetBot());
+    });
+}
+
 // Called when a player switches to a new area (more accurate than UpdateZone)
 void PlayerHookScript::OnUpdateArea(Player* player, uint32 /*oldAreaId*/, uint32 /*newAreaId*/)
 {
@@ -66,23 +118,13 @@ void PlayerHookScript::OnLevelChanged(Player* player, uint8 /*oldlevel*/)
     {
         uint8 newLevel = player->getLevel();
 
-        BotEntryMap botsMap = sBotsRegistry->GetEntryByOwnerGUID(player->GetGUID());
-
-        if (!botsMap.empty())
+        sBotsRegistry->ForEachBotOfOwner(player->GetGUID(), [newLevel](BotEntry const& entry)
         {
-            for (BotEntryMap::iterator itr = botsMap.begin(); itr != botsMap.end(); ++itr)
+            if (BotAI* ai = entry.GetBotAI())
             {
-                BotEntry* entry = itr->second;
-
-                if (entry)
-                {
-                    if (BotAI* ai = entry->GetBotAI())
-                    {
-                        ai->OnBotOwnerLevelChanged(newLevel, true);
-                    }
-                }
+                ai->OnBotOwnerLevelChanged(newLevel, true);
             }
-        }
+        });
     }
 }
 
@@ -258,3 +300,338 @@ void MovementHandlerHookScript::OnPlayerMoveTeleport(Player* player)
         BotMgr::OnBotOwnerMoveTeleport(player);
     }
 }
+
+void WorldHookScript::OnAfterConfigLoad(bool /*reload*/)
+{
+    sBotConfig->Load();
+}
+
+void WorldHookScript::OnStartup()
+{
+    sBotManaTable->Build();
+
+    if (sBotConfig->IsSelfCheckEnabled())
+    {
+        BotSelfCheck::Run();
+    }
+}
+
+void WorldHookScript::OnUpdate(uint32 diff)
+{
+    BotMgr::Update(diff);
+}
+
+void MapHookScript::OnDestroyMap(Map* map)
+{
+    sBotMapDataMgr->Remove(map);
+}
+
+// runs after the map updated its creatures, ticks granted here are used next frame
+void MapHookScript::OnMapUpdate(Map* map, uint32 diff)
+{
+    if (BotMapData* data = sBotMapDataMgr->Find(map))
+    {
+        data->Update(diff);
+    }
+}
+
+ChatCommandTable CommandHookScript::GetCommands() const
+{
+    static ChatCommandTable npcBotRegistryCommandTable =
+    {
+        { "",       HandleNpcBotRegistryCommand,        SEC_GAMEMASTER,     Console::Yes },
+        { "dump",   HandleNpcBotRegistryDumpCommand,    SEC_ADMINISTRATOR,  Console::Yes },
+    };
+
+    static ChatCommandTable npcBotPerfCommandTable =
+    {
+        { "",       HandleNpcBotPerfCommand,            SEC_GAMEMASTER,     Console::Yes },
+        { "reset",  HandleNpcBotPerfResetCommand,       SEC_ADMINISTRATOR,  Console::Yes },
+        { "dump",   HandleNpcBotPerfDumpCommand,        SEC_ADMINISTRATOR,  Console::Yes },
+    };
+
+    static ChatCommandTable npcBotPartyStatsCommandTable =
+    {
+        { "",       HandleNpcBotPartyStatsCommand,      SEC_GAMEMASTER,     Console::Yes },
+        { "reset",  HandleNpcBotPartyStatsResetCommand, SEC_ADMINISTRATOR,  Console::Yes },
+    };
+
+    static ChatCommandTable npcBotTrafficCommandTable =
+    {
+        { "",       HandleNpcBotTrafficCommand,         SEC_GAMEMASTER,     Console::Yes },
+        { "reset",  HandleNpcBotTrafficResetCommand,    SEC_ADMINISTRATOR,  Console::Yes },
+    };
+
+    static ChatCommandTable npcBotManaTableCommandTable =
+    {
+        { "",       HandleNpcBotManaTableCommand,       SEC_ADMINISTRATOR,  Console::Yes },
+        { "dump",   HandleNpcBotManaTableDumpCommand,   SEC_ADMINISTRATOR,  Console::Yes },
+    };
+
+    static ChatCommandTable npcBotCommandTable =
+    {
+        { "registry", npcBotRegistryCommandTable },
+        { "perf", npcBotPerfCommandTable },
+        { "partystats", npcBotPartyStatsCommandTable },
+        { "traffic", npcBotTrafficCommandTable },
+        { "pathcache", HandleNpcBotPathCacheCommand, SEC_GAMEMASTER, Console::Yes },
+        { "manatable", npcBotManaTableCommandTable },
+    };
+
+    static ChatCommandTable commandTable =
+    {
+        { "npcbot", npcBotCommandTable },
+    };
+
+    return commandTable;
+}
+
+// .npcbot registry
+bool CommandHookScript::HandleNpcBotRegistryCommand(ChatHandler* handler)
+{
+    std::vector<std::string> lines;
+    sBotsRegistry->BuildSummary(lines);
+
+    for (std::string const& line : lines)
+    {
+        handler->SendSysMessage(line);
+    }
+
+    return true;
+}
+
+// .npcbot registry dump [file]
+bool CommandHookScript::HandleNpcBotRegistryDumpCommand(ChatHandler* handler, Optional<std::string> fileName)
+{
+    std::string path = fileName ? *fileName : "npcbots_registry.txt";
+
+    sBotsRegistry->DumpToFile(path);
+
+    handler->SendSysMessage(Acore::StringFormatFmt("bot registry dump is being written to \"{}\".", path));
+
+    return true;
+}
+
+// .npcbot perf
+bool CommandHookScript::HandleNpcBotPerfCommand(ChatHandler* handler)
+{
+#if NPCBOTS_PROFILER
+    uint32 maps = 0;
+
+    sBotMapDataMgr->ForEach([handler, &maps](BotMapData& data)
+    {
+        Map const* map = data.GetMap();
+        BotProfiler const& profiler = data.GetProfiler();
+
+        ++maps;
+
+        handler->SendSysMessage(Acore::StringFormatFmt(
+            "map {} ({}) instance {}: phase / count / mean / p50 / p99 / max (us)",
+            map->GetId(),
+            map->GetMapName(),
+            map->GetInstanceId()));
+
+        for (uint32 phase = 0; phase < BOT_PROFILE_MAX; ++phase)
+        {
+            BotPhaseHistogram const& histogram = profiler.GetPhase(BotProfilePhase(phase));
+
+            if (!histogram.GetCount())
+            {
+                continue;
+            }
+
+            handler->SendSysMessage(Acore::StringFormatFmt(
+                "    +-- {}: {} / {:.1f} / {:.1f} / {:.1f} / {:.1f}",
+                BotProfiler::GetPhaseName(BotProfilePhase(phase)),
+                histogram.GetCount(),
+                histogram.GetMean() / 1000.f,
+                histogram.GetPercentile(0.5f) / 1000.f,
+                histogram.GetPercentile(0.99f) / 1000.f,
+                histogram.GetMax() / 1000.f));
+        }
+    });
+
+    if (!maps)
+    {
+        handler->SendSysMessage("no bot phase timings recorded yet.");
+    }
+#else
+    handler->SendSysMessage("npcbots profiler is compiled out (NPCBOTS_PROFILER=0).");
+#endif
+
+    return true;
+}
+
+// .npcbot perf reset
+bool CommandHookScript::HandleNpcBotPerfResetCommand(ChatHandler* handler)
+{
+    sBotMapDataMgr->ForEach([](BotMapData& data)
+    {
+        data.GetProfiler().Reset();
+    });
+
+    handler->SendSysMessage("bot phase timings reset.");
+
+    return true;
+}
+
+// .npcbot perf dump [file]
+bool CommandHookScript::HandleNpcBotPerfDumpCommand(ChatHandler* handler, Optional<std::string> fileName)
+{
+    std::string path = fileName ? *fileName : "npcbots_perf.csv";
+
+    std::vector<std::string> lines;
+    lines.push_back("map_id,map_name,instance_id,phase,count,mean_ns,p50_ns,p99_ns,max_ns");
+
+    sBotMapDataMgr->ForEach([&lines](BotMapData& data)
+    {
+        Map const* map = data.GetMap();
+        BotProfiler const& profiler = data.GetProfiler();
+
+        for (uint32 phase = 0; phase < BOT_PROFILE_MAX; ++phase)
+        {
+            BotPhaseHistogram const& histogram = profiler.GetPhase(BotProfilePhase(phase));
+
+            lines.push_back(Acore::StringFormatFmt(
+                "{},\"{}\",{},{},{},{},{},{},{}",
+                map->GetId(),
+                map->GetMapName(),
+                map->GetInstanceId(),
+                BotProfiler::GetPhaseName(BotProfilePhase(phase)),
+                histogram.GetCount(),
+                histogram.GetMean(),
+                histogram.GetPercentile(0.5f),
+                histogram.GetPercentile(0.99f),
+                histogram.GetMax()));
+        }
+    });
+
+    BotMgr::WriteFileAsync(path, std::move(lines), "bot perf dump");
+
+    handler->SendSysMessage(Acore::StringFormatFmt("bot phase timings are being written to \"{}\".", path));
+
+    return true;
+}
+
+// .npcbot manatable <class>
+bool CommandHookScript::HandleNpcBotManaTableCommand(ChatHandler* handler, uint32 botClass)
+{
+    if (botClass == BOT_CLASS_NONE || botClass >= BOT_CLASS_END)
+    {
+        handler->SendSysMessage(Acore::StringFormatFmt("bot class must be in range [1, {}].", uint32(BOT_CLASS_END) - 1));
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::vector<std::string> lines;
+    sBotManaTable->BuildDump(lines, botClass);
+
+    for (std::string const& line : lines)
+    {
+        handler->SendSysMessage(line);
+    }
+
+    return true;
+}
+
+// .npcbot manatable dump [file], every class
+bool CommandHookScript::HandleNpcBotManaTableDumpCommand(ChatHandler* handler, Optional<std::string> fileName)
+{
+    std::string path = fileName ? *fileName : "npcbots_manatable.txt";
+
+    std::vector<std::string> lines;
+    sBotManaTable->BuildDump(lines);
+
+    BotMgr::WriteFileAsync(path, std::move(lines), "bot mana table dump");
+
+    handler->SendSysMessage(Acore::StringFormatFmt("bot mana table is being written to \"{}\".", path));
+
+    return true;
+}
+
+// .npcbot partystats
+bool CommandHookScript::HandleNpcBotPartyStatsCommand(ChatHandler* handler)
+{
+    std::vector<std::string> lines;
+    sBotPartyStatsMgr->BuildSummary(lines);
+
+    for (std::string const& line : lines)
+    {
+        handler->SendSysMessage(line);
+    }
+
+    return true;
+}
+
+// .npcbot partystats reset
+bool CommandHookScript::HandleNpcBotPartyStatsResetCommand(ChatHandler* handler)
+{
+    sBotPartyStatsMgr->ResetCounters();
+
+    handler->SendSysMessage("bot party stats traffic counters reset.");
+
+    return true;
+}
+
+// .npcbot traffic
+bool CommandHookScript::HandleNpcBotTrafficCommand(ChatHandler* handler)
+{
+    std::vector<std::string> lines;
+    sBotTrafficMgr->BuildSummary(lines);
+
+    for (std::string const& line : lines)
+    {
+        handler->SendSysMessage(line);
+    }
+
+    return true;
+}
+
+// .npcbot traffic reset
+bool CommandHookScript::HandleNpcBotTrafficResetCommand(ChatHandler* handler)
+{
+    sBotTrafficMgr->Reset();
+
+    handler->SendSysMessage("bot traffic counters reset.");
+
+    return true;
+}
+
+// .npcbot pathcache
+bool CommandHookScript::HandleNpcBotPathCacheCommand(ChatHandler* handler)
+{
+    uint32 maps = 0;
+
+    sBotMapDataMgr->ForEach([handler, &maps](BotMapData& data)
+    {
+        Map const* map = data.GetMap();
+        BotPathCache const& cache = data.GetPathCache();
+        uint64 const lookups = cache.GetHits() + cache.GetMisses();
+
+        if (!lookups)
+        {
+            return;
+        }
+
+        ++maps;
+
+        handler->SendSysMessage(Acore::StringFormatFmt(
+            "map {} ({}) instance {}: {} paths, {} hits, {} misses ({:.1f}% hit rate), {} hits rejected, {} evictions",
+            map->GetId(),
+            map->GetMapName(),
+            map->GetInstanceId(),
+            cache.GetSize(),
+            cache.GetHits(),
+            cache.GetMisses(),
+            cache.GetHits() * 100.f / lookups,
+            cache.GetRejects(),
+            cache.GetEvictions()));
+    });
+
+    if (!maps)
+    {
+        handler->SendSysMessage("no bot paths looked up yet.");
+    }
+
+    return true;
+}
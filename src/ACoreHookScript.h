@@ -16,6 +16,13 @@ class UnitHookScript : public UnitScript
 {
 public:
     UnitHookScript() : UnitScript("npc_bots_unit_hook") { }
+
+public:
+    void OnAuraApply(Unit* /*unit*/, Aura* /*aura*/) override;
+    void OnAuraRemove(Unit* /*unit*/, AuraApplication* /*aurApp*/, AuraRemoveMode /*mode*/) override;
+
+private:
+    static void InvalidateBotAuraCaches(Unit* unit, SpellInfo const* spellInfo);
 };
 
 class PlayerHookScript : public PlayerScript
@@ -61,4 +68,47 @@ public:
     void OnPlayerMoveTeleport(Player* /*player*/) override;
 };
 
+class WorldHookScript : public WorldScript
+{
+public:
+    WorldHookScript() : WorldScript("npc_bots_world_hook") { }
+
+public:
+    void OnAfterConfigLoad(bool /*reload*/) override;
+    void OnStartup() override;
+    void OnUpdate(uint32 /*diff*/) override;
+};
+
+class MapHookScript : public AllMapScript
+{
+public:
+    MapHookScript() : AllMapScript("npc_bots_map_hook") { }
+
+public:
+    void OnDestroyMap(Map* /*map*/) override;
+    void OnMapUpdate(Map* /*map*/, uint32 /*diff*/) override;
+};
+
+class CommandHookScript : public CommandScript
+{
+public:
+    CommandHookScript() : CommandScript("npc_bots_command_hook") { }
+
+public:
+    ChatCommandTable GetCommands() const override;
+
+    static bool HandleNpcBotRegistryCommand(ChatHandler* handler);
+    static bool HandleNpcBotRegistryDumpCommand(ChatHandler* handler, Optional<std::string> fileName);
+    static bool HandleNpcBotPerfCommand(ChatHandler* handler);
+    static bool HandleNpcBotPerfResetCommand(ChatHandler* handler);
+    static bool HandleNpcBotPerfDumpCommand(ChatHandler* handler, Optional<std::string> fileName);
+    static bool HandleNpcBotManaTableCommand(ChatHandler* handler, uint32 botClass);
+    static bool HandleNpcBotManaTableDumpCommand(ChatHandler* handler, Optional<std::string> fileName);
+    static bool HandleNpcBotPartyStatsCommand(ChatHandler* handler);
+    static bool HandleNpcBotPartyStatsResetCommand(ChatHandler* handler);
+    static bool HandleNpcBotTrafficCommand(ChatHandler* handler);
+    static bool HandleNpcBotTrafficResetCommand(ChatHandler* handler);
+    static bool HandleNpcBotPathCacheCommand(ChatHandler* handler);
+};
+
 #endif  // _ACORE_HOOK_SCRIPT_H
@@ -6,9 +6,17 @@
 
 #include "BotAI.h"
 #include "BotCommon.h"
+#include "BotConfig.h"
 #include "BotEvents.h"
 #include "BotGridNotifiers.h"
+#include "BotManaTable.h"
+#include "BotMapData.h"
 #include "BotMgr.h"
+#include "BotPartyStats.h"
+#include "BotProfiler.h"
+#include "BotScheduler.h"
+#include "BotStatTalents.h"
+#include "BotTraffic.h"
 #include "CellImpl.h"
 #include "Creature.h"
 #include "GameEventMgr.h"
@@ -20,15 +28,16 @@
 #include "Vehicle.h"
 #include "Unit.h"
 
+#include <algorithm>
+
 const float MAX_PLAYER_DISTANCE = 100.0f;
+const uint32 LOD_CHECK_INTERVAL = 1000;
 
 enum ePoints
 {
     POINT_COMBAT_START  = 0xFFFFFF
 };
 
-static uint16 __rand; //calculated for each bot separately once every updateAI tick
-
 BotAI::BotAI(Creature* creature) : ScriptedAI(creature)
 {
     LOG_INFO(
@@ -37,18 +46,44 @@ BotAI::BotAI(Creature* creature) : ScriptedAI(creature)
         (unsigned long long)this,
         creature->GetName().c_str());
 
-    m_gcdTimer = 0;
-    m_uiFollowerTimer = 2500;
-    m_uiWaitTimer = 0;
-    m_uiUpdateTimerMedium = 0;
+    m_botTime = 0;
+    m_gcdReadyTime = 0;
+    m_lastUpdateDiff = 0;
+    m_potionReadyTime = 0;
+    m_isPotionCooldownPending = false;
+    m_spellReadyTime = 0;
+    m_isSpellReadyTimeStale = false;
+    m_followerTime = 2500;
+    m_formationTime = 0;
+    m_formationDist = BOT_FOLLOW_DIST;
+    m_formationAngle = BOT_FOLLOW_ANGLE;
+    m_formationPath = false;
+    m_groupUpdateTime = 0;
+    m_partyStatsFullTime = 0;
+    m_partyStatsGroupSize = 0;
     m_regenTimer = 0;
     m_energyFraction = 0.f;
+    m_regenFieldWrites = 0;
+
+    m_dataMap = nullptr;
+    m_mapData = nullptr;
+    m_thinkToken = 0;
+    m_thinkState = BOT_THINK_STATE_NONE;
+
+    m_rand = 0;
+
+    m_lodTier = BOT_LOD_FULL;
+    m_lodCheckTimer = 0;
+    m_lodSkippedDiff = 0;
 
     m_uiLeaderGUID = ObjectGuid::Empty;
     m_uiBotState = STATE_FOLLOW_NONE;
 
     m_bot = creature;
 
+    // re-seeded with the owner's slot when hired
+    SeedRandom(0);
+
     if (creature->GetOwnerGUID() != ObjectGuid::Empty)
     {
         if (Player* player = ObjectAccessor::FindPlayer(m_bot->GetOwnerGUID()))
@@ -69,12 +104,29 @@ BotAI::BotAI(Creature* creature) : ScriptedAI(creature)
 
     m_isFeastMana = false;
     m_isFeastHealth = false;
+    m_feastManaSpellId = 0;
+    m_feastHealthSpellId = 0;
+    m_rationState = BOT_RATION_IDLE;
+    m_rationTime = 0;
     m_isDoUpdateMana = false;
 
     m_botClass = CLASS_NONE;
     m_classLevelInfo = nullptr;
     m_botSpec = BOT_SPEC_DEFAULT;
 
+    std::fill(std::begin(m_statCache), std::end(m_statCache), 0.f);
+    m_statCacheStance = BOT_STANCE_NONE;
+    m_isStatCacheDirty = true;
+
+    m_isRegenAuraCacheDirty = true;
+    m_energyRegenMult = 1.f;
+    m_healthRegenMult = 1.f;
+    m_healthRegenMod = 0;
+    m_healthRegenInCombatPct = 0;
+    m_healthRegenInCombatMod = 0;
+    m_hasHealthRegenInCombatPct = false;
+    m_hasHealthRegenInCombatMod = false;
+
     m_haste = 0;
     m_hit = 0.f;
     m_parry = 0.f;
@@ -103,13 +155,6 @@ BotAI::~BotAI()
         "BotAI::~BotAI (this: 0X{:016x}, name: {})",
         (unsigned long long)this, m_bot->GetName().c_str());
 
-    while (!m_spells.empty())
-    {
-        BotSpellMap::iterator itr = m_spells.begin();
-        delete itr->second;
-        m_spells.erase(itr);
-    }
-
     LOG_INFO(
         "npcbots",
         "BotAI::~BotAI (this: 0X{:016x}, name: {})",
@@ -167,6 +212,8 @@ void BotAI::AttackStart(Unit* who)
         return;
     }
 
+    PromoteLOD();
+
     if (m_bot->Attack(who, true))
     {
         if (m_bot->HasUnitState(UNIT_STATE_FOLLOW))
@@ -273,6 +320,8 @@ void BotAI::EnterEvadeMode(EvadeReason why)
 
 void BotAI::EnterCombat(Unit* /*victim*/)
 {
+    PromoteLOD();
+
     // clear gossip during combat.
     if (m_bot->HasFlag(UNIT_NPC_FLAGS, UNIT_NPC_FLAG_GOSSIP))
     {
@@ -280,6 +329,11 @@ void BotAI::EnterCombat(Unit* /*victim*/)
     }
 }
 
+void BotAI::DamageTaken(Unit* /*attacker*/, uint32& /*damage*/, DamageEffectType /*damagetype*/, SpellSchoolMask /*damageSchoolMask*/)
+{
+    PromoteLOD();
+}
+
 void BotAI::JustDied(Unit* /*killer*/)
 {
     if (!HasBotState(STATE_FOLLOW_INPROGRESS) || !m_uiLeaderGUID)
@@ -297,6 +351,7 @@ void BotAI::JustDied(Unit* /*killer*/)
                 {
                     if (grp->IsMember(m_bot->GetGUID()))
                     {
+                        RecordGroupUpdateTraffic(grp);
                         grp->SendUpdate();
                     }
                 }
@@ -331,13 +386,25 @@ bool BotAI::OnBeforeCreatureUpdate(uint32 uiDiff)
 
 bool BotAI::UpdateCommonBotAI(uint32 uiDiff)
 {
+    if (!UpdateLOD(uiDiff))
+    {
+        return false;
+    }
+
     m_lastUpdateDiff = uiDiff;
 
-    UpdateFollowerAI(uiDiff);
+    UpdateMapData();
 
-    if (m_uiUpdateTimerMedium <= uiDiff)
     {
-        m_uiUpdateTimerMedium = 500;
+        BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_FOLLOWER);
+        UpdateFollowerAI(uiDiff);
+    }
+
+    if (IsTimeReached(m_groupUpdateTime))
+    {
+        BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_GROUP_UPDATE);
+
+        uint32 interval = sBotConfig->GetPartyStatsInterval();
 
         if (m_bot->IsInWorld())
         {
@@ -349,23 +416,23 @@ bool BotAI::UpdateCommonBotAI(uint32 uiDiff)
                     {
                         if (grp->IsMember(m_bot->GetGUID()))
                         {
-                            WorldPacket data;
-                            BuildGrouUpdatePacket(&data);
+                            // new members need every field, see BOT_PARTY_STATS_FULL_INTERVAL
+                            bool full = IsTimeReached(m_partyStatsFullTime) || grp->GetMembersCount() != m_partyStatsGroupSize;
 
-                            for (GroupReference const* itr = grp->GetFirstMember();
-                                itr != nullptr;
-                                itr = itr->next())
+                            if (full)
                             {
-                                if (itr->GetSource())
-                                {
-                                    itr->GetSource()->GetSession()->SendPacket(&data);
-                                }
+                                m_partyStatsFullTime = m_botTime + BOT_PARTY_STATS_FULL_INTERVAL;
+                                m_partyStatsGroupSize = grp->GetMembersCount();
                             }
+
+                            interval = PublishPartyStats(grp, full);
                         }
                     }
                 }
             }
         }
+
+        m_groupUpdateTime = m_botTime + interval;
     }
 
     if (!m_bot->IsAlive())
@@ -379,7 +446,10 @@ bool BotAI::UpdateCommonBotAI(uint32 uiDiff)
         OnManaUpdate();
     }
 
-    Regenerate();
+    {
+        BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_REGENERATE);
+        Regenerate();
+    }
 
     // update flags
     if (!m_bot->IsInCombat())
@@ -395,9 +465,12 @@ bool BotAI::UpdateCommonBotAI(uint32 uiDiff)
         }
     }
 
-    UpdateBotRations();
+    {
+        BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_RATIONS);
+        UpdateBotRations();
+    }
 
-    if (DelayUpdateIfNeeded())
+    if (!ConsumeThinkTick())
     {
         return false;
     }
@@ -409,8 +482,15 @@ bool BotAI::UpdateCommonBotAI(uint32 uiDiff)
         return false;
     }
 
-    UpdateMountedState();
-    UpdateStandState();
+    {
+        BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_MOUNT);
+        UpdateMountedState();
+    }
+
+    {
+        BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_STAND);
+        UpdateStandState();
+    }
 
     return true;
 }
@@ -426,40 +506,8 @@ void BotAI::OnManaUpdate() const
 
     bool fullmana = m_bot->GetPower(POWER_MANA) == m_bot->GetMaxPower(POWER_MANA);
     float pct = fullmana ? 100.f : (float(m_bot->GetPower(POWER_MANA)) * 100.f) / float(m_bot->GetMaxPower(POWER_MANA));
-    float baseMana = 0.0f;
-
-    if (m_botClass == BOT_CLASS_BM)
-    {
-        baseMana = (float)BASE_MANA_1_BM + (BASE_MANA_10_BM - BASE_MANA_1_BM) * (mylevel / 81.f);
-    }
-    else if (m_botClass == BOT_CLASS_SPHYNX)
-    {
-        baseMana = BASE_MANA_SPHYNX;
-    }
-    else if (m_botClass == BOT_CLASS_ARCHMAGE)
-    {
-        baseMana = (float)BASE_MANA_1_ARCHMAGE + (BASE_MANA_10_ARCHMAGE - BASE_MANA_1_ARCHMAGE) * ((mylevel - 20) / 81.f);
-    }
-    else if (m_botClass == BOT_CLASS_DREADLORD)
-    {
-        baseMana = (float)BASE_MANA_1_DREADLORD + (BASE_MANA_10_DREADLORD - BASE_MANA_1_DREADLORD) * ((mylevel - 60) / 83.f);
-    }
-    else if (m_botClass == BOT_CLASS_SPELLBREAKER)
-    {
-        baseMana = BASE_MANA_SPELLBREAKER;
-    }
-    else if (m_botClass == BOT_CLASS_DARK_RANGER)
-    {
-        baseMana = (float)BASE_MANA_1_DARK_RANGER + (BASE_MANA_10_DARK_RANGER - BASE_MANA_1_DARK_RANGER) * ((mylevel - 40) / 82.f);
-    }
-    else if (m_botClass == BOT_CLASS_NECROMANCER)
-    {
-        baseMana = BASE_MANA_NECROMANCER;
-    }
-    else
-    {
-        baseMana = m_classLevelInfo->BaseMana;
-    }
+    BotManaCurve const& curve = sBotManaTable->GetCurve(m_botClass, mylevel);
+    float baseMana = curve.hasFixedBaseMana ? curve.baseMana : float(m_classLevelInfo->BaseMana);
 
     LOG_DEBUG(
         "npcbots",
@@ -478,23 +526,15 @@ void BotAI::OnManaUpdate() const
     intellectValue -= std::min<float>(m_bot->GetCreateStat(STAT_INTELLECT), 20.f); //not a mistake
     intellectValue = std::max<float>(intellectValue, 0.f);
 
-    float intellectMult = m_botClass < BOT_CLASS_EX_START ? 15.f : IsHeroExClass(m_botClass) ? 5.f : 1.5f;
+    float intellectMult = curve.intellectMult;
 
     baseMana += intellectValue * intellectMult + 20.f;
     baseMana += GetTotalBotStat(BOT_STAT_MOD_MANA);
 
     //mana bonuses
-    uint8 bonuspct = 0;
-
-    //Fel Vitality
-    if (m_botClass == BOT_CLASS_WARLOCK && mylevel >= 15)
+    if (curve.manaBonusPct)
     {
-        bonuspct += 3;
-    }
-
-    if (bonuspct)
-    {
-        baseMana = (baseMana * (100 + bonuspct)) / 100;
+        baseMana = (baseMana * (100 + curve.manaBonusPct)) / 100;
     }
 
     baseMana = baseMana * m_bot->GetCreatureTemplate()->ModMana;
@@ -544,14 +584,16 @@ void BotAI::OnManaRegenUpdate() const
     float power_regen_mp5;
     int32 modManaRegenInterrupt;
 
+    BotManaCurve const& curve = sBotManaTable->GetCurve(m_botClass, mylevel);
+
     if (m_botClass < BOT_CLASS_EX_START)
     {
         // Mana regen from spirit and intellect
         float spiregen = 0.001f;
 
-        if (GtRegenMPPerSptEntry const* moreRatio = sGtRegenMPPerSptStore.LookupEntry((m_botClass - 1) * GT_MAX_LEVEL + mylevel - 1))
+        if (curve.hasSpiritRegenRatio)
         {
-            spiregen = moreRatio->ratio * GetTotalBotStat(BOT_STAT_MOD_SPIRIT);
+            spiregen = curve.spiritRegenRatio * GetTotalBotStat(BOT_STAT_MOD_SPIRIT);
         }
 
         // PCT bonus from SPELL_AURA_MOD_POWER_REGEN_PERCENT aura on spirit base regen
@@ -584,48 +626,19 @@ void BotAI::OnManaRegenUpdate() const
         modManaRegenInterrupt = 100;
         power_regen_mp5 = 0.0f;
 
-        if (IsHeroExClass(m_botClass))
+        if (m_botClass == BOT_CLASS_SPHYNX)
         {
-            float basemana;
+            value = CalculatePct(m_bot->GetCreateMana(), 2); //-2% basemana/sec
+        }
+        else if (curve.hasBaseRegen)
+        {
+            value = curve.baseRegen;
 
-            if (BOT_CLASS_EX_START == BOT_CLASS_BM)
-            {
-                basemana = BASE_MANA_1_BM;
-            }
-            else if (BOT_CLASS_EX_START == BOT_CLASS_ARCHMAGE)
-            {
-                basemana = BASE_MANA_1_ARCHMAGE;
-            }
-            else if (BOT_CLASS_EX_START == BOT_CLASS_DREADLORD)
-            {
-                basemana = BASE_MANA_1_DREADLORD;
-            }
-            else if (BOT_CLASS_EX_START == BOT_CLASS_DARK_RANGER)
-            {
-                basemana = BASE_MANA_1_DARK_RANGER;
-            }
-            else
+            if (curve.intellectRegenMult > 0.f)
             {
-                basemana = 0.f;
+                value += curve.intellectRegenMult * GetTotalBotStat(BOT_STAT_MOD_INTELLECT);
             }
 
-            value = basemana * 0.0087f + 0.08f * GetTotalBotStat(BOT_STAT_MOD_INTELLECT);
-            value += 0.2f * (m_bot->GetTotalAuraModifierByMiscValue(SPELL_AURA_MOD_POWER_REGEN, POWER_MANA) + GetTotalBotStat(BOT_STAT_MOD_MANA_REGENERATION));
-            value *= m_bot->GetTotalAuraMultiplierByMiscValue(SPELL_AURA_MOD_POWER_REGEN_PERCENT, POWER_MANA);
-        }
-        else if (m_botClass == BOT_CLASS_SPHYNX)
-        {
-            value = CalculatePct(m_bot->GetCreateMana(), 2); //-2% basemana/sec
-        }
-        else if (m_botClass == BOT_CLASS_SPELLBREAKER)
-        {
-            value = 4.f; //base 0.8/sec
-            value += 0.2f * (m_bot->GetTotalAuraModifierByMiscValue(SPELL_AURA_MOD_POWER_REGEN, POWER_MANA) + GetTotalBotStat(BOT_STAT_MOD_MANA_REGENERATION));
-            value *= m_bot->GetTotalAuraMultiplierByMiscValue(SPELL_AURA_MOD_POWER_REGEN_PERCENT, POWER_MANA);
-        }
-        else if (m_botClass == BOT_CLASS_NECROMANCER)
-        {
-            value = 7.5f; //base 1.5/sec
             value += 0.2f * (m_bot->GetTotalAuraModifierByMiscValue(SPELL_AURA_MOD_POWER_REGEN, POWER_MANA) + GetTotalBotStat(BOT_STAT_MOD_MANA_REGENERATION));
             value *= m_bot->GetTotalAuraMultiplierByMiscValue(SPELL_AURA_MOD_POWER_REGEN_PERCENT, POWER_MANA);
         }
@@ -651,632 +664,381 @@ void BotAI::OnManaRegenUpdate() const
     m_bot->SetStatFloatValue(UNIT_FIELD_POWER_REGEN_FLAT_MODIFIER, power_regen_mp5 + value);
 }
 
-inline float BotAI::GetTotalBotStat(uint8 stat) const
+float BotAI::GetTotalBotStat(uint8 stat) const
+{
+    if (m_isStatCacheDirty || m_statCacheStance != GetBotStance())
+    {
+        UpdateStatCache();
+    }
+
+    return stat < MAX_BOT_ITEM_MOD ? m_statCache[stat] : 0.f;
+}
+
+void BotAI::UpdateStatCache() const
+{
+    for (uint8 stat = 0; stat != MAX_BOT_ITEM_MOD; ++stat)
+    {
+        m_statCache[stat] = CalculateTotalBotStat(stat);
+    }
+
+    m_statCacheStance = GetBotStance();
+    m_isStatCacheDirty = false;
+}
+
+void BotAI::SetBotSpec(uint8 spec)
+{
+    if (m_botSpec != spec)
+    {
+        m_botSpec = spec;
+        InvalidateStatCache();
+    }
+}
+
+// auras which can change the values returned by GetTotalBotStat()
+bool BotAI::IsStatAura(uint32 auraname)
+{
+    return auraname == SPELL_AURA_MOD_STAT || auraname == SPELL_AURA_MOD_PERCENT_STAT ||
+        auraname == SPELL_AURA_MOD_TOTAL_STAT_PERCENTAGE || auraname == SPELL_AURA_MOD_SKILL ||
+        auraname == SPELL_AURA_MOD_ATTACK_POWER || auraname == SPELL_AURA_MOD_ATTACK_POWER_PCT ||
+        auraname == SPELL_AURA_MOD_ATTACK_POWER_OF_STAT_PERCENT || auraname == SPELL_AURA_MOD_ATTACK_POWER_OF_ARMOR ||
+        auraname == SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT ||
+        auraname == SPELL_AURA_MOD_RATING || auraname == SPELL_AURA_MOD_RATING_FROM_STAT;
+}
+
+float BotAI::CalculateTotalBotStat(uint8 stat) const
 {
     int32 value = 0;
 
 // *********************************************************************
 // TODO: implement this => equipment bonus.
+//    equipment changes must call InvalidateStatCache()
 //    for (uint8 slot = BOT_SLOT_MAINHAND; slot != BOT_INVENTORY_SIZE; ++slot)
 //    {
 //        value += _stats[slot][stat];
 //    }
 // *********************************************************************
 
-    uint8 lvl = m_bot->getLevel();
     float fval = float(value);
 
     switch (stat)
     {
         case BOT_STAT_MOD_STRENGTH:
-        {
             fval += m_bot->GetTotalStatValue(STAT_STRENGTH);
+            break;
+        case BOT_STAT_MOD_AGILITY:
+            fval += m_bot->GetTotalStatValue(STAT_AGILITY);
+            break;
+        case BOT_STAT_MOD_STAMINA:
+            fval += m_bot->GetTotalStatValue(STAT_STAMINA);
+            break;
+        case BOT_STAT_MOD_INTELLECT:
+            fval += m_bot->GetTotalStatValue(STAT_INTELLECT);
+            break;
+        case BOT_STAT_MOD_SPIRIT:
+            fval += m_bot->GetTotalStatValue(STAT_SPIRIT);
+            break;
+        default:
+            return fval;
+    }
 
-            switch (m_botClass)
-            {
-                case BOT_CLASS_WARRIOR:
-                {
-                    //Vitality, Strength of Arms
-                    if (lvl >= 45 && m_botSpec == BOT_SPEC_WARRIOR_PROTECTION)
-                    {
-                        fval *= 1.06f;
-                    }
+    // talents, see BotStatTalents.cpp
+    uint8 lvl = m_bot->getLevel();
 
-                    if (lvl >= 40 && m_botSpec == BOT_SPEC_WARRIOR_ARMS)
-                    {
-                        fval *= 1.04f;
-                    }
+    fval *= GetBotTalentStatMultiplier(m_botClass, m_botSpec, stat, lvl);
+    fval *= GetBotStanceStatMultiplier(m_botClass, m_botSpec, GetBotStance(), stat, lvl);
 
-                    //Improved Berserker Stance part 1 (all stances)
-                    if (lvl >= 45 && m_botSpec == BOT_SPEC_WARRIOR_FURY)
-                    {
-                        fval *= 1.2f;
-                    }
+    return fval;
+}
 
-                    break;
-                }
-                case BOT_CLASS_PALADIN:
-                {
-                    //Divine Strength
-                    if (lvl >= 10)
-                    {
-                        fval *= 1.15f;
-                    }
+uint8 BotAI::GetBotStance() const
+{
+    return BOT_STANCE_NONE;
+}
 
-                    break;
-                }
-                case BOT_CLASS_DEATH_KNIGHT:
-                {
-                    //Ravenous Dead part 1
-                    //Endless Winter part 1
-                    //Veteran of the Third War part 1
-                    //Abomination's might part 2
-                    if (lvl >= 56)
-                    {
-                        fval *= 1.03f;
-                    }
+// Fixed global seed: the seed only depends on ids which are the same on every run
+// (owner guid counter, creature entry, spawn id and the slot among the owner's bots
+// of that entry), never on the bot guid, which is a new temp summon guid each run.
+// Otherwise seeded from the core generator.
+void BotAI::SeedRandom(uint32 slot)
+{
+    uint64 seed = sBotConfig->GetAIRandomSeed();
 
-                    if (lvl >= 58)
-                    {
-                        fval *= 1.04f;
-                    }
+    if (!seed)
+    {
+        m_random.Seed((uint64(urand(0, 0xFFFFFFFF)) << 32) | urand(0, 0xFFFFFFFF));
+        return;
+    }
 
-                    if (lvl >= 59 && m_botSpec == BOT_SPEC_DK_BLOOD)
-                    {
-                        fval *= 1.06f;
-                    }
+    uint64 ownerKey = (uint64(m_bot->GetOwnerGUID().GetCounter()) << 32) | m_bot->GetEntry();
+    uint64 slotKey = (uint64(m_bot->GetSpawnId()) << 8) | (slot & 0xFF);
 
-                    if (lvl >= 60 && m_botSpec == BOT_SPEC_DK_BLOOD)
-                    {
-                        fval *= 1.02f;
-                    }
+    m_random.Seed(BotRandom::SplitMix64(seed) ^ BotRandom::SplitMix64(ownerKey) ^ slotKey);
+}
 
-                    //Frost Presence passive / Improved Frost Presence
-                    if (lvl >= 61 && GetBotStance() == DEATH_KNIGHT_FROST_PRESENCE && m_botSpec == BOT_SPEC_DK_FROST)
-                    {
-                        fval *= 1.08f;
-                    }
+// Returns false if the update pipeline is skipped this tick. Skipped time is
+// accumulated and handed to the next update through uiDiff, so regen and
+// follower timers do not lose time in the lower tiers.
+bool BotAI::UpdateLOD(uint32& uiDiff)
+{
+    if (!sBotConfig->IsLODEnabled())
+    {
+        return true;
+    }
 
-                    break;
-                }
-                case BOT_CLASS_DRUID:
-                {
-                    //Survival of the Fittest, Improved Mark of the Wild
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_DRUID_FERAL)
-                    {
-                        fval *= 1.08f;
-                    }
-                    else if (lvl >= 10)
-                    {
-                        fval *= 1.02f;
-                    }
+    m_lodCheckTimer += uiDiff;
 
-                    break;
-                }
-                default:
-                {
-                    break;
-                }
-            }
+    if (m_lodTier != BOT_LOD_FULL)
+    {
+        // combat and the owner coming into range promote at once (a flag test and one
+        // squared distance), other players are picked up by the once per interval check
+        Unit* owner = GetBotOwner();
+        float distance = sBotConfig->GetLODFullRateDistance();
 
-            break;
+        if (m_bot->IsInCombat() ||
+            (owner && owner->IsInWorld() && owner->FindMap() == m_bot->FindMap() &&
+             m_bot->GetExactDistSq(owner) <= distance * distance))
+        {
+            PromoteLOD();
         }
+    }
 
-        case BOT_STAT_MOD_AGILITY:
-        {
-            fval += m_bot->GetTotalStatValue(STAT_AGILITY);
+    if (m_lodCheckTimer >= LOD_CHECK_INTERVAL)
+    {
+        m_lodCheckTimer = 0;
+        m_lodTier = CalculateLODTier();
+    }
 
-            switch (m_botClass)
-            {
-                case BOT_CLASS_HUNTER:
-                {
-                    //Combat Experience, Lightning Reflexes
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_HUNTER_MARKSMANSHIP)
-                    {
-                        fval *= 1.04f;
-                    }
+    if (m_lodTier == BOT_LOD_FULL)
+    {
+        uiDiff += m_lodSkippedDiff;
+        m_lodSkippedDiff = 0;
 
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_HUNTER_SURVIVAL)
-                    {
-                        fval *= 1.15f;
-                    }
+        return true;
+    }
 
-                    //Hunting Party
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_HUNTER_SURVIVAL)
-                    {
-                        fval *= 1.03f;
-                    }
+    m_lodSkippedDiff += uiDiff;
 
-                    break;
-                }
+    uint32 interval = m_lodTier == BOT_LOD_REDUCED ?
+        sBotConfig->GetLODReducedInterval() :
+        sBotConfig->GetLODParkedInterval();
 
-                case BOT_CLASS_ROGUE:
-                {
-                    //Sinister Calling
-                    if (lvl >= 45 && m_botSpec == BOT_SPEC_ROGUE_SUBTLETY)
-                    {
-                        fval *= 1.15f;
-                    }
+    if (m_lodSkippedDiff < interval)
+    {
+        return false;
+    }
 
-                    break;
-                }
+    uiDiff = m_lodSkippedDiff;
+    m_lodSkippedDiff = 0;
 
-                case BOT_CLASS_DRUID:
-                {
-                    //Survival of the Fittest, Improved Mark of the Wild
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_DRUID_FERAL)
-                    {
-                        fval *= 1.08f;
-                    }
-                    else if (lvl >= 10)
-                    {
-                        fval *= 1.02f;
-                    }
+    return true;
+}
 
-                    break;
-                }
+uint8 BotAI::CalculateLODTier() const
+{
+    if (m_bot->IsInCombat() || m_bot->GetVictim())
+    {
+        return BOT_LOD_FULL;
+    }
 
-                default:
-                {
-                    break;
-                }
-            }
+    Map* map = m_bot->FindMap();
 
-            break;
-        }
+    if (!map || !map->HavePlayers())
+    {
+        return BOT_LOD_PARKED;
+    }
 
-        case BOT_STAT_MOD_STAMINA:
-        {
-            fval += m_bot->GetTotalStatValue(STAT_STAMINA);
+    float distance = sBotConfig->GetLODFullRateDistance();
+    Map::PlayerList const& players = map->GetPlayers();
 
-            switch (m_botClass)
-            {
-                case BOT_CLASS_WARRIOR:
-                {
-                    //Vitality, Strength of Arms
-                    if (lvl >= 45 && m_botSpec == BOT_SPEC_WARRIOR_PROTECTION)
-                    {
-                        fval *= 1.09f;
-                    }
+    for (Map::PlayerList::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
 
-                    if (lvl >= 40 && m_botSpec == BOT_SPEC_WARRIOR_ARMS)
-                    {
-                        fval *= 1.04f;
-                    }
+        if (player && m_bot->IsWithinDistInMap(player, distance))
+        {
+            return BOT_LOD_FULL;
+        }
+    }
 
-                    break;
-                }
+    return BOT_LOD_REDUCED;
+}
 
-                case BOT_CLASS_PALADIN:
-                {
-                    //Combat Expertise, Sacred Duty
-                    if (lvl >= 45 && m_botSpec == BOT_SPEC_PALADIN_PROTECTION)
-                    {
-                        fval *= 1.06f;
-                    }
+// damage, aggro and the owner coming into range switch to full rate right away.
+// the tier is re-evaluated no sooner than one check interval later.
+void BotAI::PromoteLOD()
+{
+    if (m_lodTier != BOT_LOD_FULL)
+    {
+        m_lodTier = BOT_LOD_FULL;
+        m_lodCheckTimer = 0;
+    }
+}
 
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_PALADIN_PROTECTION)
-                    {
-                        fval *= 1.04f;
-                    }
+// the think pipeline (combat ai included) only runs on ticks granted by the map's
+// BotScheduler. a tick is consumed and the next one queued in the same call.
+bool BotAI::ConsumeThinkTick()
+{
+    if (!UpdateMapData())
+    {
+        return false;
+    }
 
-                    break;
-                }
-
-                case BOT_CLASS_HUNTER:
-                {
-                    //Survivalist
-                    if (lvl >= 20)
-                    {
-                        fval *= 1.1f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_ROGUE:
-                {
-                    //Lightning Reflexes part 2
-                    if (lvl >= 25 && m_botSpec == BOT_SPEC_ROGUE_COMBAT)
-                    {
-                        fval *= 1.04f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_PRIEST:
-                {
-                    //Improved Power Word: Shield
-                    if (lvl >= 15)
-                    {
-                        fval *= 1.04f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_DEATH_KNIGHT:
-                {
-                    //Veteran of the Third War part 2
-                    if (lvl >= 59 && m_botSpec == BOT_SPEC_DK_BLOOD)
-                    {
-                        fval *= 1.03f;
-                    }
-
-                    break;
-                }
+    if (m_thinkState == BOT_THINK_STATE_NONE)
+    {
+        // first update on this map, queue somewhere within one interval so bots
+        // spawned together do not think together
+        m_thinkState = BOT_THINK_STATE_QUEUED;
+        m_mapData->GetScheduler().Schedule(m_bot->GetGUID(), ++m_thinkToken, m_random.URand(0, GetThinkInterval()), GetThinkPriority());
 
-                case BOT_CLASS_WARLOCK:
-                {
-                    //Demonic Embrace: 10% stam bonus
-                    if (lvl >= 10)
-                    {
-                        fval *= 1.1f;
-                    }
+        return false;
+    }
 
-                    break;
-                }
+    if (m_thinkState != BOT_THINK_STATE_GRANTED)
+    {
+        return false;
+    }
 
-                case BOT_CLASS_DRUID:
-                {
-                    if (GetBotStance() == DRUID_BEAR_FORM)
-                    {
-                        //Bear form: stamina bonus base 25%
-                        //Heart of the Wild: 10% stam bonus for bear
-                        fval *= 1.25f;
-                        if (lvl >= 35 && m_botSpec == BOT_SPEC_DRUID_FERAL)
-                            fval *= 1.1f;
-                    }
+    // keep the granted tick until the owner is back in world
+    Unit* owner = GetBotOwner();
 
-                    //Survival of the Fittest, Improved Mark of the Wild
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_DRUID_FERAL)
-                    {
-                        fval *= 1.06f;
-                    }
+    if (owner && !owner->IsInWorld())
+    {
+        return false;
+    }
 
-                    if (lvl >= 10)
-                    {
-                        fval *= 1.02f;
-                    }
+    m_thinkState = BOT_THINK_STATE_QUEUED;
+    m_mapData->GetScheduler().Schedule(m_bot->GetGUID(), ++m_thinkToken, GetThinkInterval(), GetThinkPriority());
 
-                    break;
-                }
+    return true;
+}
 
-                default:
-                {
-                    break;
-                }
-            }
+// looks the map data up again whenever the bot is on another map than last time
+BotMapData* BotAI::UpdateMapData()
+{
+    Map* map = m_bot->FindMap();
 
-            break;
-        }
+    if (m_dataMap != map)
+    {
+        m_dataMap = map;
+        m_mapData = map ? sBotMapDataMgr->GetOrCreate(map) : nullptr;
+        m_thinkState = BOT_THINK_STATE_NONE;
 
-        case BOT_STAT_MOD_INTELLECT:
+        if (m_mapData)
         {
-            fval += m_bot->GetTotalStatValue(STAT_INTELLECT);
-
-            switch (m_botClass)
-            {
-                case BOT_CLASS_PALADIN:
-                {
-                    // Divine Intellect
-                    if (lvl >= 15)
-                    {
-                        fval *= 1.1f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_HUNTER:
-                {
-                    //Combat Experience
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_HUNTER_MARKSMANSHIP)
-                    {
-                        fval *= 1.04f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_MAGE:
-                {
-                    //Arcane Mind
-                    if (lvl >= 30 && m_botSpec == BOT_SPEC_MAGE_ARCANE)
-                    {
-                        fval *= 1.15f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_PRIEST:
-                {
-                    //Mental Strength
-                    if (lvl >= 30 && m_botSpec == BOT_SPEC_PRIEST_DISCIPLINE)
-                    {
-                        fval *= 1.15f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_SHAMAN:
-                {
-                    //Ancestral Knowledge
-                    if (lvl >= 10)
-                    {
-                        fval *= 1.1f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_DRUID:
-                {
-                    //Survival of the Fittest, Improved Mark of the Wild
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_DRUID_FERAL)
-                    {
-                        fval *= 1.08f;
-                    }
-                    else if (lvl >= 10)
-                    {
-                        fval *= 1.02f;
-                    }
-
-                    //Furor (Moonkin Form)
-                    if (GetBotStance() == DRUID_MOONKIN_FORM)
-                    {
-                        fval *= 1.1f;
-                    }
-
-                    //Heart of the Wild: ferals only (tanks included)
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_DRUID_FERAL)
-                    {
-                        fval *= 1.2f;
-                    }
-
-                    break;
-                }
-
-                default:
-                {
-                    break;
-                }
-            }
-
-            break;
-        }
-
-        case BOT_STAT_MOD_SPIRIT:
-        {
-            fval += m_bot->GetTotalStatValue(STAT_SPIRIT);
-
-            switch (m_botClass)
-            {
-                case BOT_CLASS_PRIEST:
-                {
-                    //Spirit of Redemption part 1
-                    if (lvl >= 30 && m_botSpec == BOT_SPEC_PRIEST_HOLY)
-                    {
-                        fval *= 1.05f;
-                    }
-
-                    //Enlightenment part 1
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_PRIEST_DISCIPLINE)
-                    {
-                        fval *= 1.06f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_MAGE:
-                {
-                    //Student of the Mind
-                    if (lvl >= 20)
-                    {
-                        fval *= 1.1f;
-                    }
-
-                    break;
-                }
-
-                case BOT_CLASS_DRUID:
-                {
-                    //Survival of the Fittest, Improved Mark of the Wild
-                    if (lvl >= 35 && m_botSpec == BOT_SPEC_DRUID_FERAL)
-                    {
-                        fval *= 1.08f;
-                    }
-                    else if (lvl >= 10)
-                    {
-                        fval *= 1.02f;
-                    }
-
-                    //Living Spirit
-                    if (lvl >= 40 && m_botSpec == BOT_SPEC_DRUID_RESTORATION)
-                    {
-                        fval *= 1.15f;
-                    }
-
-                    break;
-                }
-
-                default:
-                {
-                    break;
-                }
-            }
-
-            break;
+            m_mapData->GetRegenBatch().Register(m_bot->GetGUID());
         }
     }
 
-    return fval;
-}
-
-uint8 BotAI::GetBotStance() const
-{
-    return BOT_STANCE_NONE;
+    return m_mapData;
 }
 
-bool BotAI::DelayUpdateIfNeeded()
+// SMSG_GROUP_LIST estimate, counted by the map while the bot is on one
+void BotAI::RecordGroupUpdateTraffic(Group const* group)
 {
-    Unit* owner = GetBotOwner();
+    Unit const* owner = GetBotOwner();
+    ObjectGuid ownerGUID = owner ? owner->GetGUID() : ObjectGuid::Empty;
 
-    if (m_uiWaitTimer > m_lastUpdateDiff || (owner && !owner->IsInWorld()))
+    if (BotMapData* mapData = UpdateMapData())
     {
-        return true;
-    }
-
-    if (IAmFree())
-    {
-        m_uiWaitTimer = m_bot->IsInCombat() ? 500 : urand(750, 1250);
-    }
-    else if ((owner && !owner->GetMap()->IsRaid()))
-    {
-        m_uiWaitTimer = std::min<uint32>(uint32(50 * (BotMgr::GetBotsCount(owner) - 1) + __rand + __rand), 500);
+        mapData->GetTraffic().RecordGroupUpdate(group, m_bot->GetGUID(), ownerGUID);
     }
     else
     {
-        m_uiWaitTimer = __rand;
+        sBotTrafficMgr->RecordGroupUpdate(group, m_bot->GetGUID(), ownerGUID);
     }
-
-    return false;
 }
 
-void BotAI::BuildGrouUpdatePacket(WorldPacket* data)
+BotProfiler* BotAI::GetProfiler() const
 {
-    uint32 mask = GROUP_UPDATE_FULL;
-
-    if (mask & GROUP_UPDATE_FLAG_POWER_TYPE)
-    {
-        mask |= (GROUP_UPDATE_FLAG_CUR_POWER | GROUP_UPDATE_FLAG_MAX_POWER);
-    }
+    return m_mapData ? &m_mapData->GetProfiler() : nullptr;
+}
 
-    if (mask & GROUP_UPDATE_FLAG_PET_POWER_TYPE)
+void BotAI::OnThinkTickGranted(uint32 token)
+{
+    // items queued before the bot left and re-entered the map are stale
+    if (token == m_thinkToken && m_thinkState == BOT_THINK_STATE_QUEUED)
     {
-        mask |= (GROUP_UPDATE_FLAG_PET_CUR_POWER | GROUP_UPDATE_FLAG_PET_MAX_POWER);
+        m_thinkState = BOT_THINK_STATE_GRANTED;
     }
+}
 
-    uint32 byteCount = 0;
+uint32 BotAI::GetThinkInterval()
+{
+    Unit* owner = GetBotOwner();
 
-    for (uint8 i = 1; i < GROUP_UPDATE_FLAGS_COUNT; ++i)
+    if (IAmFree())
     {
-        if (mask & (1 << i))
-        {
-            byteCount += GroupUpdateLength[i];
-        }
+        return m_bot->IsInCombat() ? 500 : m_random.URand(750, 1250);
     }
-
-    data->Initialize(SMSG_PARTY_MEMBER_STATS, 8 + 4 + byteCount);
-    *data << m_bot->GetGUID().WriteAsPacked();
-    *data << uint32(mask);
-
-    if (mask & GROUP_UPDATE_FLAG_STATUS)
+    else if ((owner && !owner->GetMap()->IsRaid()))
     {
-        uint16 playerStatus = MEMBER_STATUS_ONLINE;
-
-        if (m_bot->IsPvP())
-        {
-            playerStatus |= MEMBER_STATUS_PVP;
-        }
-
-        if (!m_bot->IsAlive())
-        {
-            playerStatus |= MEMBER_STATUS_DEAD;
-        }
-
-        if (m_bot->HasByteFlag(UNIT_FIELD_BYTES_2, 1, UNIT_BYTE2_FLAG_FFA_PVP))
-        {
-            playerStatus |= MEMBER_STATUS_PVP_FFA;
-        }
-
-        *data << uint16(playerStatus);
+        return std::min<uint32>(uint32(50 * (BotMgr::GetBotsCount(owner) - 1) + m_rand + m_rand), 500);
     }
-
-    if (mask & GROUP_UPDATE_FLAG_CUR_HP)
+    else
     {
-        *data << uint32(m_bot->GetHealth());
+        return m_rand;
     }
+}
 
-    if (mask & GROUP_UPDATE_FLAG_MAX_HP)
+uint8 BotAI::GetThinkPriority() const
+{
+    if (m_bot->IsInCombat())
     {
-        *data << uint32(m_bot->GetMaxHealth());
+        return BOT_THINK_PRIORITY_COMBAT;
     }
 
-    Powers powerType = m_bot->getPowerType();
+    return IAmFree() ? BOT_THINK_PRIORITY_IDLE : BOT_THINK_PRIORITY_FOLLOWER;
+}
 
-    if (mask & GROUP_UPDATE_FLAG_POWER_TYPE)
-    {
-        *data << uint8(powerType);
-    }
+// Publishes the party frame fields changed since the last update (all fields
+// if full) to the group, see BotPartyStatsMgr. Nothing is sent if nothing changed.
+// Returns the delay until the next update:
+//   combat interval - in combat, or health / power changing fast
+//   idle interval   - nothing changed, or no player near the bot
+//   interval        - otherwise
+uint32 BotAI::PublishPartyStats(Group const* grp, bool full)
+{
+    BotPartyStats stats;
+    stats.Capture(m_bot);
 
-    if (mask & GROUP_UPDATE_FLAG_CUR_POWER)
-    {
-        *data << uint16(m_bot->GetPower(powerType));
-    }
+    uint32 mask = full ? uint32(BOT_PARTY_STATS_FIELDS) : stats.GetChangedMask(m_partyStatsSent);
 
-    if (mask & GROUP_UPDATE_FLAG_MAX_POWER)
+    if (!mask)
     {
-        *data << uint16(m_bot->GetMaxPower(powerType));
+        return m_bot->IsInCombat() ? sBotConfig->GetPartyStatsCombatInterval() : sBotConfig->GetPartyStatsIdleInterval();
     }
 
-    if (mask & GROUP_UPDATE_FLAG_LEVEL)
-    {
-        *data << uint16(m_bot->getLevel());
-    }
+    uint32 const fastPct = sBotConfig->GetPartyStatsFastChangePct();
+    bool const fastChange = fastPct && (
+        uint64(std::abs(int64(stats.health) - int64(m_partyStatsSent.health))) * 100 >= uint64(fastPct) * stats.maxHealth ||
+        (stats.maxPower && uint64(std::abs(int32(stats.power) - int32(m_partyStatsSent.power))) * 100 >= uint64(fastPct) * stats.maxPower));
 
-    if (mask & GROUP_UPDATE_FLAG_ZONE)
-    {
-        *data << uint16(m_bot->GetZoneId());
-    }
+    sBotPartyStatsMgr->Publish(grp->GetGUID().GetCounter(), m_bot->GetGUID(), m_bot->GetOwnerGUID(), stats, mask);
+    m_partyStatsSent = stats;
 
-    if (mask & GROUP_UPDATE_FLAG_POSITION)
+    if (m_bot->IsInCombat() || (!full && fastChange))
     {
-        *data << uint16(m_bot->GetPositionX());
-        *data << uint16(m_bot->GetPositionY());
+        return sBotConfig->GetPartyStatsCombatInterval();
     }
 
-    if (mask & GROUP_UPDATE_FLAG_VEHICLE_SEAT)
+    if (m_lodTier != BOT_LOD_FULL)
     {
-        if (Vehicle* veh = m_bot->GetVehicle())
-        {
-            *data << uint32(veh->GetVehicleInfo()->m_seatID[m_bot->m_movementInfo.transport.seat]);
-        }
-        else
-        {
-            *data << uint32(0);
-        }
+        return sBotConfig->GetPartyStatsIdleInterval();
     }
+
+    return sBotConfig->GetPartyStatsInterval();
 }
 
 void BotAI::UpdateCommonTimers(uint32 uiDiff)
 {
-    Events.Update(uiDiff);
-
-    UpdateSpellCD(uiDiff);
+    m_botTime += uiDiff;
 
-    if (m_gcdTimer > uiDiff)
-    {
-        m_gcdTimer -= uiDiff;
-    }
-
-    if (m_uiWaitTimer > uiDiff)
-    {
-        m_uiWaitTimer -= uiDiff;
-    }
-
-    if (m_potionTimer > uiDiff && (m_potionTimer < POTION_CD || !m_bot->IsInCombat()))
-    {
-        m_potionTimer -= uiDiff;
-    }
+    Events.Update(uiDiff);
 
-    if (m_uiUpdateTimerMedium > uiDiff)
+    if (m_isPotionCooldownPending && !m_bot->IsInCombat())
     {
-        m_uiUpdateTimerMedium -= uiDiff;
+        m_isPotionCooldownPending = false;
+        m_potionReadyTime = m_botTime + POTION_CD;
     }
 }
 
@@ -1286,9 +1048,15 @@ void BotAI::UpdateFollowerAI(uint32 uiDiff)
 
     if (HasBotState(STATE_FOLLOW_INPROGRESS) && !victim)
     {
-        if (m_uiFollowerTimer <= uiDiff)
+        if (IsTimeReached(m_formationTime) && !HasBotState(STATE_FOLLOW_RETURNING))
         {
-            m_uiFollowerTimer = 1000;
+            m_formationTime = m_botTime + FORMATION_CD;
+            UpdateFormation();
+        }
+
+        if (IsTimeReached(m_followerTime))
+        {
+            m_followerTime = m_botTime + 1000;
 
             if (Unit* leader = GetLeaderForFollower())
             {
@@ -1299,7 +1067,7 @@ void BotAI::UpdateFollowerAI(uint32 uiDiff)
                     LOG_DEBUG("npcbots", "bot [{}] is returning to leader.", m_bot->GetName().c_str());
 
                     RemoveBotState(STATE_FOLLOW_RETURNING);
-                    m_bot->GetMotionMaster()->MoveFollow(leader, BOT_FOLLOW_DIST, BOT_FOLLOW_ANGLE);
+                    MoveFollowLeader(leader);
 
                     return;
                 }
@@ -1310,16 +1078,27 @@ void BotAI::UpdateFollowerAI(uint32 uiDiff)
                 {
                     if (Group* group = player->GetGroup())
                     {
-                        for (GroupReference* groupRef = group->GetFirstMember();
-                             groupRef != nullptr;
-                             groupRef = groupRef->next())
+                        // one query against the group summary shared by the bots of the map
+                        if (BotMapData* mapData = UpdateMapData())
                         {
-                            Player* member = groupRef->GetSource();
-
-                            if (member && m_bot->IsWithinDistInMap(member, MAX_PLAYER_DISTANCE))
+                            if (mapData->GetGroupProximity().IsWithinDistOfAnyMember(group, m_bot, MAX_PLAYER_DISTANCE))
                             {
                                 bIsMaxRangeExceeded = false;
-                                break;
+                            }
+                        }
+                        else
+                        {
+                            for (GroupReference* groupRef = group->GetFirstMember();
+                                 groupRef != nullptr;
+                                 groupRef = groupRef->next())
+                            {
+                                Player* member = groupRef->GetSource();
+
+                                if (member && m_bot->IsWithinDistInMap(member, MAX_PLAYER_DISTANCE))
+                                {
+                                    bIsMaxRangeExceeded = false;
+                                    break;
+                                }
                             }
                         }
                     }
@@ -1376,10 +1155,6 @@ void BotAI::UpdateFollowerAI(uint32 uiDiff)
                 m_bot->DespawnOrUnsummon();
             }
         }
-        else
-        {
-            m_uiFollowerTimer -= uiDiff;
-        }
     }
     else if (HasBotState(STATE_FOLLOW_COMPLETE))
     {
@@ -1413,6 +1188,7 @@ void BotAI::UpdateAI(uint32 uiDiff)
         return;
     }
 
+    BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_COMBAT);
     UpdateBotCombatAI(uiDiff);
 }
 
@@ -1427,21 +1203,10 @@ void BotAI::UpdateBotRations()
         {
             if (noFeast || m_bot->IsStandState() || m_bot->GetMaxPower(POWER_MANA) <= 1 || m_bot->GetPower(POWER_MANA) >= m_bot->GetMaxPower(POWER_MANA))
             {
-                std::list<uint32> spellIds;
-                Unit::AuraApplicationMap const& aurApps = m_bot->GetAppliedAuras();
-
-                for (Unit::AuraApplicationMap::const_iterator ci = aurApps.begin(); ci != aurApps.end(); ++ci)
+                if (m_feastManaSpellId)
                 {
-                    if (ci->second->GetBase()->GetSpellInfo()->GetSpellSpecific() == SPELL_SPECIFIC_DRINK &&
-                        !ci->second->GetBase()->GetSpellInfo()->HasAura(SPELL_AURA_PERIODIC_TRIGGER_SPELL)) //skip buffing food
-                    {
-                        spellIds.push_back(ci->first);
-                    }
-                }
-
-                for (std::list<uint32>::const_iterator cit = spellIds.begin(); cit != spellIds.end(); ++cit)
-                {
-                    m_bot->RemoveAurasDueToSpell(*cit);
+                    m_bot->RemoveAurasDueToSpell(m_feastManaSpellId);
+                    m_feastManaSpellId = 0;
                 }
 
                 m_isFeastMana = false;
@@ -1452,21 +1217,10 @@ void BotAI::UpdateBotRations()
         {
             if (noFeast || m_bot->IsStandState() || m_bot->GetHealth() >= m_bot->GetMaxHealth())
             {
-                std::list<uint32> spellIds;
-                Unit::AuraApplicationMap const& aurApps = m_bot->GetAppliedAuras();
-
-                for (Unit::AuraApplicationMap::const_iterator ci = aurApps.begin(); ci != aurApps.end(); ++ci)
+                if (m_feastHealthSpellId)
                 {
-                    if (ci->second->GetBase()->GetSpellInfo()->GetSpellSpecific() == SPELL_SPECIFIC_FOOD &&
-                        !ci->second->GetBase()->GetSpellInfo()->HasAura(SPELL_AURA_PERIODIC_TRIGGER_SPELL)) //skip buffing food
-                    {
-                        spellIds.push_back(ci->first);
-                    }
-                }
-
-                for (std::list<uint32>::const_iterator cit = spellIds.begin(); cit != spellIds.end(); ++cit)
-                {
-                    m_bot->RemoveAurasDueToSpell(*cit);
+                    m_bot->RemoveAurasDueToSpell(m_feastHealthSpellId);
+                    m_feastHealthSpellId = 0;
                 }
 
                 m_isFeastHealth = false;
@@ -1474,13 +1228,53 @@ void BotAI::UpdateBotRations()
         }
     }
 
-    if (noFeast)
+    if (noFeast)
+    {
+        m_rationState = BOT_RATION_IDLE;
+        return;
+    }
+
+    if (!IsTimeReached(m_rationTime))
+    {
+        return;
+    }
+
+    bool drink = WantsToDrink();
+    bool eat = WantsToEat();
+
+    if (m_rationState == BOT_RATION_IDLE)
+    {
+        if (drink || eat)
+        {
+            // short reaction delay before sitting down
+            m_rationState = BOT_RATION_PENDING;
+            m_rationTime = m_botTime + m_random.URand(200, 1000);
+        }
+        else
+        {
+            m_rationTime = m_botTime + RATION_CD;
+        }
+
+        return;
+    }
+
+    if (drink)
+    {
+        m_bot->CastSpell(m_bot, GetRation(true), true);
+    }
+
+    if (eat)
     {
-        return;
+        m_bot->CastSpell(m_bot, GetRation(false), true);
     }
 
-    // drink
-    if (!m_isFeastMana &&
+    m_rationState = BOT_RATION_IDLE;
+    m_rationTime = m_botTime + RATION_CD;
+}
+
+bool BotAI::WantsToDrink() const
+{
+    return !m_isFeastMana &&
         m_bot->GetMaxPower(POWER_MANA) > 1 &&
         !m_bot->HasAuraType(SPELL_AURA_MOUNTED) &&
         !m_bot->isMoving() &&
@@ -1488,25 +1282,19 @@ void BotAI::UpdateBotRations()
         !m_bot->IsInCombat() &&
         !m_bot->GetVehicle() &&
         !IsCasting() &&
-        GetManaPCT(m_bot) < 50 &&
-        urand(0, 100) < 20)
-    {
-        m_bot->CastSpell(m_bot, GetRation(true), true);
-    }
+        GetManaPCT(m_bot) < 50;
+}
 
-    // eat
-    if (!m_isFeastHealth &&
+bool BotAI::WantsToEat() const
+{
+    return !m_isFeastHealth &&
         !m_bot->HasAuraType(SPELL_AURA_MOUNTED) &&
         !m_bot->isMoving() &&
         CanEat() &&
         !m_bot->IsInCombat() &&
         !m_bot->GetVehicle() &&
         !IsCasting() &&
-        GetHealthPCT(m_bot) < 80 &&
-        urand(0, 100) < 20)
-    {
-        m_bot->CastSpell(m_bot, GetRation(false), true);
-    }
+        GetHealthPCT(m_bot) < 80;
 }
 
 // MOUNT SUPPORT
@@ -1746,12 +1534,24 @@ void BotAI::SpellHit(Unit* caster, SpellInfo const* spell)
     if (spell->GetSpellSpecific() == SPELL_SPECIFIC_DRINK)
     {
         m_isFeastMana = true;
+
+        if (!spell->HasAura(SPELL_AURA_PERIODIC_TRIGGER_SPELL)) //skip buffing food
+        {
+            m_feastManaSpellId = spell->Id;
+        }
+
         UpdateMana();
         m_regenTimer = 0;
     }
     else if (spell->GetSpellSpecific() == SPELL_SPECIFIC_FOOD)
     {
         m_isFeastHealth = true;
+
+        if (!spell->HasAura(SPELL_AURA_PERIODIC_TRIGGER_SPELL)) //skip buffing food
+        {
+            m_feastHealthSpellId = spell->Id;
+        }
+
         m_regenTimer = 0;
     }
 
@@ -1801,15 +1601,9 @@ void BotAI::SpellHit(Unit* caster, SpellInfo const* spell)
         }
 
         // update stats
-        if (auraname == SPELL_AURA_MOD_STAT || auraname == SPELL_AURA_MOD_PERCENT_STAT ||
-            auraname == SPELL_AURA_MOD_TOTAL_STAT_PERCENTAGE || auraname == SPELL_AURA_MOD_SKILL ||
-            auraname == SPELL_AURA_MOD_ATTACK_POWER || auraname == SPELL_AURA_MOD_ATTACK_POWER_PCT ||
-            auraname == SPELL_AURA_MOD_ATTACK_POWER_OF_STAT_PERCENT || auraname == SPELL_AURA_MOD_ATTACK_POWER_OF_ARMOR ||
-            auraname == SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT ||
-            auraname == SPELL_AURA_MOD_RATING || auraname == SPELL_AURA_MOD_RATING_FROM_STAT)
+        if (IsStatAura(auraname))
         {
-            // TODO: implement this => shouldUpdateStats
-            //shouldUpdateStats = true;
+            InvalidateStatCache();
         }
         else if (auraname == SPELL_AURA_MOD_INCREASE_HEALTH ||
             auraname == SPELL_AURA_MOD_INCREASE_HEALTH_2 ||
@@ -1967,7 +1761,7 @@ void BotAI::StartFollow(Unit* leader, uint32 factionForFollower)
     }
     else
     {
-        m_bot->GetMotionMaster()->MoveFollow(leader, BOT_FOLLOW_DIST, BOT_FOLLOW_ANGLE);
+        MoveFollowLeader(leader);
 
         LOG_DEBUG(
             "npcbots", "bot [{}] start follow [{}].",
@@ -1994,6 +1788,113 @@ void BotAI::SetFollowComplete()
     }
 }
 
+// follows at the bot's formation slot, BOT_FOLLOW_DIST / BOT_FOLLOW_ANGLE without a formation.
+// in a formation the follow generator goes to the idle slot: the splines along the
+// shared leader path run above it (active slot) and it takes over when they end,
+// so the bot keeps UNIT_STATE_FOLLOW throughout.
+void BotAI::MoveFollowLeader(Unit* leader)
+{
+    float dist = BOT_FOLLOW_DIST;
+    float angle = BOT_FOLLOW_ANGLE;
+    bool formation = false;
+
+    if (BotMapData* mapData = UpdateMapData())
+    {
+        formation = mapData->GetFormations().GetSlotOffset(leader, m_bot, dist, angle);
+    }
+
+    m_formationDist = dist;
+    m_formationAngle = angle;
+
+    if (formation)
+    {
+        m_bot->GetMotionMaster()->MoveFollow(leader, dist, angle, MOTION_SLOT_IDLE);
+
+        // the generator replaced in the idle slot cleared it, the new one only sets it once on top
+        m_bot->AddUnitState(UNIT_STATE_FOLLOW);
+    }
+    else
+    {
+        m_bot->GetMotionMaster()->MoveFollow(leader, dist, angle);
+    }
+}
+
+// keeps the formation slot of the bot. the bot is moved to its slot along the
+// leader path shared by the followers of the leader (one path query per leader
+// move for all of them); only when the slot or the path can not be used the
+// follow generator below finds a path of its own. any other movement is left alone.
+void BotAI::UpdateFormation()
+{
+    if (sBotConfig->GetFormationType() == BOT_FORMATION_NONE)
+    {
+        return;
+    }
+
+    if (m_bot->GetVehicle() || m_bot->HasUnitState(UNIT_STATE_CASTING) || JumpingOrFalling())
+    {
+        return;
+    }
+
+    Unit* leader = GetLeaderForFollower();
+    BotMapData* mapData = UpdateMapData();
+
+    if (!leader || !mapData || leader->FindMap() != m_bot->FindMap())
+    {
+        return;
+    }
+
+    MotionMaster* motion = m_bot->GetMotionMaster();
+
+    // started following outside of a formation, see MoveFollowLeader()
+    if (motion->GetMotionSlotType(MOTION_SLOT_IDLE) != FOLLOW_MOTION_TYPE)
+    {
+        return;
+    }
+
+    MovementGeneratorType const current = motion->GetCurrentMovementGeneratorType();
+
+    if (current != FOLLOW_MOTION_TYPE && (current != ESCORT_MOTION_TYPE || !m_formationPath))
+    {
+        return;
+    }
+
+    BotFormations& formations = mapData->GetFormations();
+
+    // bots joining or leaving the formation move the slots of the others
+    float dist = BOT_FOLLOW_DIST;
+    float angle = BOT_FOLLOW_ANGLE;
+
+    if (formations.GetSlotOffset(leader, m_bot, dist, angle) &&
+        (std::fabs(dist - m_formationDist) >= 0.1f || std::fabs(angle - m_formationAngle) >= 0.01f))
+    {
+        m_formationDist = dist;
+        m_formationAngle = angle;
+
+        motion->MoveFollow(leader, dist, angle, MOTION_SLOT_IDLE);
+        m_bot->AddUnitState(UNIT_STATE_FOLLOW);
+    }
+
+    Movement::PointsArray points;
+
+    switch (formations.GetSlotMove(leader, m_bot, points))
+    {
+        case BOT_FORMATION_MOVE_NONE:
+            break;
+        case BOT_FORMATION_MOVE_PATH:
+            m_bot->SetWalk(leader->IsWalking());
+            motion->MoveSplinePath(&points);
+            m_formationPath = true;
+            break;
+        case BOT_FORMATION_MOVE_FALLBACK:
+            // back to the follow generator, it paths to the offset on its own
+            if (current == ESCORT_MOTION_TYPE)
+            {
+                motion->MovementExpired();
+            }
+            break;
+    }
+}
+
 Unit* BotAI::GetLeaderForFollower()
 {
     if (Unit* leader = ObjectAccessor::GetUnit(*m_bot, m_uiLeaderGUID))
@@ -2080,10 +1981,10 @@ bool BotAI::IAmFree() const
 
 uint16 BotAI::Rand() const
 {
-    return __rand;
+    return m_rand;
 }
 
-void BotAI::GenerateRand() const
+void BotAI::GenerateRand()
 {
     int botCount = 0;
     Unit* owner = GetBotOwner();
@@ -2093,30 +1994,37 @@ void BotAI::GenerateRand() const
         botCount = BotMgr::GetBotsCount(owner);
     }
 
-    __rand = urand(0, IAmFree() ? 100 : 100 + (botCount - 1) * 2);
+    m_rand = m_random.URand(0, IAmFree() ? 100 : 100 + (botCount - 1) * 2);
 }
 
-bool BotAI::IsSpellReady(uint32 basespell, uint32 diff, bool checkGCD) const
+bool BotAI::IsSpellReady(uint32 basespell, bool checkGCD) const
 {
-    if (checkGCD && m_gcdTimer > diff)
+    int32 slot = FindSpellSlot(basespell);
+
+    return slot >= 0 && IsSpellSlotReady(slot, checkGCD);
+}
+
+bool BotAI::IsSpellSlotReady(uint32 slot, bool checkGCD) const
+{
+    if (checkGCD && !IsGCDReady())
     {
         return false;
     }
 
-    BotSpellMap::const_iterator itr = m_spells.find(basespell);
-
-    if (itr == m_spells.end())
+    if (slot >= m_spellBook.size())
     {
         return false;
     }
 
-    BotSpell* spell = itr->second;
+    BotSpell const& spell = m_spellBook[slot];
 
-    return (spell->enabled == true || IAmFree()) && spell->spellId != 0 && spell->cooldown <= diff;
+    return (spell.enabled == true || IAmFree()) && spell.spellId != 0 && IsTimeReached(spell.readyTime);
 }
 
 Unit* BotAI::FindAOETarget(float dist, uint32 minTargetNum) const
 {
+    BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_TARGET_SEARCH);
+
     std::list<Unit*> unitList;
     Acore::AnyUnfriendlyUnitInObjectRangeCheck u_check(m_bot, m_bot, dist);
     Acore::UnitListSearcher<Acore::AnyUnfriendlyUnitInObjectRangeCheck> searcher(m_bot, unitList, u_check);
@@ -2191,6 +2099,8 @@ Unit* BotAI::FindAOETarget(float dist, uint32 minTargetNum) const
 //Finds target for CC spells with MECHANIC_STUN
 Unit* BotAI::FindStunTarget(float dist) const
 {
+    BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_TARGET_SEARCH);
+
     std::list<Unit*> unitList;
 
     Acore::StunUnitCheck check(m_bot, dist);
@@ -2214,6 +2124,8 @@ Unit* BotAI::FindStunTarget(float dist) const
 //Can be used to get silence/interruption/reflect/grounding check
 Unit* BotAI::FindCastingTarget(float maxdist, float mindist, uint32 spellId, uint8 minHpPct) const
 {
+    BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_TARGET_SEARCH);
+
     std::list<Unit*> unitList;
 
     Acore::CastingUnitCheck check(m_bot, mindist, maxdist, spellId, minHpPct);
@@ -2235,6 +2147,8 @@ Unit* BotAI::FindCastingTarget(float maxdist, float mindist, uint32 spellId, uin
 
 void BotAI::GetNearbyTargetsInConeList(std::list<Unit*> &targets, float maxdist) const
 {
+    BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_TARGET_SEARCH);
+
     Acore::NearbyHostileUnitInConeCheck check(m_bot, maxdist, this);
     Acore::UnitListSearcher<Acore::NearbyHostileUnitInConeCheck> searcher(m_bot, targets, check);
     Cell::VisitAllObjects(m_bot, searcher, maxdist);
@@ -2242,20 +2156,51 @@ void BotAI::GetNearbyTargetsInConeList(std::list<Unit*> &targets, float maxdist)
 
 uint32 BotAI::GetBotSpellId(uint32 basespell) const
 {
-    BotSpellMap::const_iterator itr = m_spells.find(basespell);
+    int32 slot = FindSpellSlot(basespell);
 
-    return itr != m_spells.end() && 
-                    (itr->second->enabled == true || IAmFree()) ? itr->second->spellId : 0;
+    return slot >= 0 ? GetBotSpellIdBySlot(slot) : 0;
 }
 
-// Using first-rank spell as source, puts spell of max rank allowed for given caster in spellmap
-void BotAI::InitSpellMap(uint32 basespell, bool forceadd, bool forwardRank)
+uint32 BotAI::GetBotSpellIdBySlot(uint32 slot) const
+{
+    if (slot >= m_spellBook.size())
+    {
+        return 0;
+    }
+
+    BotSpell const& spell = m_spellBook[slot];
+
+    return spell.enabled == true || IAmFree() ? spell.spellId : 0;
+}
+
+int32 BotAI::FindSpellSlot(uint32 basespell) const
+{
+    std::vector<BotSpellIndex>::const_iterator itr = std::lower_bound(
+        m_spellIndex.begin(),
+        m_spellIndex.end(),
+        basespell,
+        [](BotSpellIndex const& index, uint32 spell) { return index.basespell < spell; });
+
+    return itr != m_spellIndex.end() && itr->basespell == basespell ? int32(itr->slot) : -1;
+}
+
+// called once at class init, before any InitSpellSlot(...)
+void BotAI::InitSpellBook(uint32 slotCount)
+{
+    m_spellBook.assign(slotCount, BotSpell());
+
+    m_spellIndex.clear();
+    m_spellIndex.reserve(slotCount);
+}
+
+// Using first-rank spell as source, puts spell of max rank allowed for given caster in spell book slot
+void BotAI::InitSpellSlot(uint32 slot, uint32 basespell, bool forceadd, bool forwardRank)
 {
     SpellInfo const* info = sSpellMgr->GetSpellInfo(basespell);
 
     if (!info)
     {
-        LOG_ERROR("npcbots", "BotAI::InitSpellMap(): No SpellInfo found for base spell {}", basespell);
+        LOG_ERROR("npcbots", "BotAI::InitSpellSlot(): No SpellInfo found for base spell {}", basespell);
         return; //invalid spell id
     }
 
@@ -2268,61 +2213,133 @@ void BotAI::InitSpellMap(uint32 basespell, bool forceadd, bool forwardRank)
         info = info->GetNextRankSpell();    // check next rank
     }
 
-    BotSpell* newSpell = m_spells[basespell];
+    if (slot >= m_spellBook.size())
+    {
+        m_spellBook.resize(slot + 1);
+    }
+
+    m_spellBook[slot].spellId = spellId;
 
-    if (!newSpell)
+    std::vector<BotSpellIndex>::iterator itr = std::lower_bound(
+        m_spellIndex.begin(),
+        m_spellIndex.end(),
+        basespell,
+        [](BotSpellIndex const& index, uint32 spell) { return index.basespell < spell; });
+
+    if (itr != m_spellIndex.end() && itr->basespell == basespell)
+    {
+        itr->slot = slot;
+    }
+    else
     {
-        newSpell = new BotSpell();
-        m_spells[basespell] = newSpell;
+        m_spellIndex.insert(itr, { basespell, slot });
     }
 
-    newSpell->spellId = spellId;
+    // the slot may have lost its spell (level too low)
+    LowerSpellReadyTime(m_spellBook[slot].readyTime, true);
 }
 
-void BotAI::SetGlobalCooldown(uint32 gcd)
+// spell without a class slot: reuses its slot if already known, takes the next free one otherwise
+void BotAI::InitSpellMap(uint32 basespell, bool forceadd, bool forwardRank)
 {
-    m_gcdTimer = gcd;
+    int32 slot = FindSpellSlot(basespell);
+
+    InitSpellSlot(slot >= 0 ? uint32(slot) : uint32(m_spellBook.size()), basespell, forceadd, forwardRank);
+}
 
+void BotAI::SetGlobalCooldown(uint32 gcd)
+{
     //global cd cannot be less than 1000 ms
-    m_gcdTimer = std::max<uint32>(m_gcdTimer, 1000);
+    gcd = std::max<uint32>(gcd, 1000);
 
     //global cd cannot be greater than 1500 ms
-    m_gcdTimer = std::min<uint32>(m_gcdTimer, 1500);
+    gcd = std::min<uint32>(gcd, 1500);
+
+    m_gcdReadyTime = m_botTime + gcd;
 }
 
 void BotAI::SetSpellCooldown(uint32 basespell, uint32 msCooldown)
 {
-    BotSpellMap::const_iterator itr = m_spells.find(basespell);
+    int32 slot = FindSpellSlot(basespell);
 
-    if (itr != m_spells.end())
+    if (slot < 0)
     {
-        itr->second->cooldown = msCooldown;
-        return;
+        if (!msCooldown)
+        {
+            return;
+        }
+
+        InitSpellMap(basespell, true, false);
+
+        if ((slot = FindSpellSlot(basespell)) < 0)
+        {
+            return;
+        }
     }
-    else if (!msCooldown)
+
+    SetSpellSlotCooldown(slot, msCooldown);
+}
+
+void BotAI::SetSpellSlotCooldown(uint32 slot, uint32 msCooldown)
+{
+    if (slot >= m_spellBook.size())
     {
         return;
     }
 
-    InitSpellMap(basespell, true, false);
-    SetSpellCooldown(basespell, msCooldown);
+    m_spellBook[slot].readyTime = m_botTime + msCooldown;
+
+    LowerSpellReadyTime(m_spellBook[slot].readyTime, true);
 }
 
 void BotAI::ReduceSpellCooldown(uint32 basespell, uint32 uiDiff)
 {
-    BotSpellMap::const_iterator itr = m_spells.find(basespell);
+    int32 slot = FindSpellSlot(basespell);
 
-    if (itr != m_spells.end())
+    if (slot >= 0)
     {
-        if (itr->second->cooldown > uiDiff)
-        {
-            itr->second->cooldown -= uiDiff;
-        }
-        else
+        BotSpell& spell = m_spellBook[slot];
+
+        // never move the deadline into the past, IsTimeReached(...) is enough for that
+        spell.readyTime = spell.readyTime > m_botTime + uiDiff ? spell.readyTime - uiDiff : m_botTime;
+
+        LowerSpellReadyTime(spell.readyTime, false);
+    }
+}
+
+uint32 BotAI::GetNextSpellWakeTime()
+{
+    if (m_isSpellReadyTimeStale && IsTimeReached(m_spellReadyTime))
+    {
+        RescanSpellReadyTime();
+    }
+
+    return std::max(m_gcdReadyTime, m_spellReadyTime);
+}
+
+// mayRaise: the old deadline of the slot may have been the first one
+void BotAI::LowerSpellReadyTime(uint32 readyTime, bool mayRaise)
+{
+    m_spellReadyTime = std::min(m_spellReadyTime, readyTime);
+    m_isSpellReadyTimeStale = m_isSpellReadyTimeStale || mayRaise;
+}
+
+void BotAI::RescanSpellReadyTime()
+{
+    uint32 earliest = 0;
+    bool found = false;
+
+    for (BotSpell const& spell : m_spellBook)
+    {
+        if (spell.spellId && (!found || spell.readyTime < earliest))
         {
-            itr->second->cooldown = 0;
+            earliest = spell.readyTime;
+            found = true;
         }
     }
+
+    m_spellReadyTime = earliest;
+    m_isSpellReadyTimeStale = false;
 }
 
 void BotAI::OnBotSpellGo(Spell const* spell, bool ok)
@@ -2373,6 +2390,8 @@ void BotAI::OnBotOwnerLevelChanged(uint8 newLevel, bool showLevelChange)
 
     m_classLevelInfo = sObjectMgr->GetCreatureBaseStats(newLevel, cInfo->unit_class);
 
+    InvalidateStatCache();
+
     // health
     float healthmod = sWorld->getRate(RATE_CREATURE_ELITE_ELITE_HP);
 
@@ -2437,85 +2456,116 @@ void BotAI::Regenerate()
     {
         m_regenTimer -= REGEN_CD;
 
-        // Regen Health
-        int32 baseRegen = int32(GetTotalBotStat(BOT_STAT_MOD_HEALTH_REGEN));;
+        // health and mana are handled by the map pass, see BotRegenBatch
+        if (!sBotConfig->IsRegenBatchEnabled())
+        {
+            if (uint32 add = CalculateHealthRegen())
+            {
+                m_bot->ModifyHealth(int32(add));
+                ++m_regenFieldWrites;
+            }
+
+            if (uint32 add = CalculateManaRegen())
+            {
+                m_bot->ModifyPower(POWER_MANA, int32(add));
+                ++m_regenFieldWrites;
+            }
+        }
 
-        if (!m_bot->IsInCombat() ||
-            m_bot->IsPolymorphed() ||
-            baseRegen > 0 ||
-            m_bot->HasAuraType(SPELL_AURA_MOD_REGEN_DURING_COMBAT) ||
-            m_bot->HasAuraType(SPELL_AURA_MOD_HEALTH_REGEN_IN_COMBAT))
+        // energy writes every tick, report them once per REGEN_CD
+        if (m_regenFieldWrites)
         {
-            if (m_bot->GetHealth() < m_bot->GetMaxHealth())
+            if (BotMapData* mapData = UpdateMapData())
             {
-                int32 add = m_bot->IsInCombat() ? 0 : IAmFree() && !m_bot->GetVictim() ? m_bot->GetMaxHealth() / 32 : 5 + m_bot->GetCreateHealth() / 256;
+                mapData->GetTraffic().Record(
+                    BOT_TRAFFIC_UPDATE_FIELDS,
+                    m_bot->GetGUID(),
+                    m_bot->GetOwnerGUID(),
+                    0,
+                    uint64(m_regenFieldWrites) * BOT_TRAFFIC_UPDATE_FIELD_BYTES);
+            }
 
-                if (baseRegen > 0)
-                {
-                    add += std::max<int32>(baseRegen / 5, 1);
-                }
+            m_regenFieldWrites = 0;
+        }
+    }
+}
 
-                if (m_bot->IsPolymorphed())
-                {
-                    add += m_bot->GetMaxHealth() / 6;
-                }
-                else if (!m_bot->IsInCombat() || m_bot->HasAuraType(SPELL_AURA_MOD_REGEN_DURING_COMBAT))
-                {
-                    if (!m_bot->IsInCombat())
-                    {
-                        Unit::AuraEffectList const& mModHealthRegenPct = m_bot->GetAuraEffectsByType(SPELL_AURA_MOD_HEALTH_REGEN_PERCENT);
+// health regenerated by one REGEN_CD tick
+uint32 BotAI::CalculateHealthRegen() const
+{
+    if (m_bot->GetHealth() >= m_bot->GetMaxHealth())
+    {
+        return 0;
+    }
 
-                        for (Unit::AuraEffectList::const_iterator i = mModHealthRegenPct.begin();
-                             i != mModHealthRegenPct.end();
-                             ++i)
-                        {
-                            AddPct(add, (*i)->GetAmount());
-                        }
+    if (m_isRegenAuraCacheDirty)
+    {
+        UpdateRegenAuraCache();
+    }
 
-                        add += m_bot->GetTotalAuraModifier(SPELL_AURA_MOD_REGEN) * REGEN_CD / 5000;
-                    }
-                    else if (m_bot->HasAuraType(SPELL_AURA_MOD_REGEN_DURING_COMBAT))
-                    {
-                        ApplyPct(add, m_bot->GetTotalAuraModifier(SPELL_AURA_MOD_REGEN_DURING_COMBAT));
-                    }
-                }
+    int32 baseRegen = int32(GetTotalBotStat(BOT_STAT_MOD_HEALTH_REGEN));
 
-                add += m_bot->GetTotalAuraModifier(SPELL_AURA_MOD_HEALTH_REGEN_IN_COMBAT);
+    if (m_bot->IsInCombat() &&
+        !m_bot->IsPolymorphed() &&
+        baseRegen <= 0 &&
+        !m_hasHealthRegenInCombatPct &&
+        !m_hasHealthRegenInCombatMod)
+    {
+        return 0;
+    }
 
-                if (add < 0)
-                {
-                    add = 0;
-                }
+    int32 add = m_bot->IsInCombat() ? 0 : IAmFree() && !m_bot->GetVictim() ? m_bot->GetMaxHealth() / 32 : 5 + m_bot->GetCreateHealth() / 256;
 
-                m_bot->ModifyHealth(add);
-            }
-        }
+    if (baseRegen > 0)
+    {
+        add += std::max<int32>(baseRegen / 5, 1);
+    }
 
-        // Regen Mana
-        if (m_bot->GetMaxPower(POWER_MANA) > 1 &&
-            m_bot->GetPower(POWER_MANA) < m_bot->GetMaxPower(POWER_MANA))
+    if (m_bot->IsPolymorphed())
+    {
+        add += m_bot->GetMaxHealth() / 6;
+    }
+    else if (!m_bot->IsInCombat() || m_hasHealthRegenInCombatPct)
+    {
+        if (!m_bot->IsInCombat())
+        {
+            add = int32(add * m_healthRegenMult);
+            add += m_healthRegenMod * REGEN_CD / 5000;
+        }
+        else
         {
-            float addvalue;
+            ApplyPct(add, m_healthRegenInCombatPct);
+        }
+    }
 
-            if (m_bot->IsUnderLastManaUseEffect())
-            {
-                addvalue = m_bot->GetFloatValue(UNIT_FIELD_POWER_REGEN_INTERRUPTED_FLAT_MODIFIER);
-            }
-            else
-            {
-                addvalue = m_bot->GetFloatValue(UNIT_FIELD_POWER_REGEN_FLAT_MODIFIER);
-            }
+    add += m_healthRegenInCombatMod;
 
-            addvalue *= sWorld->getRate(RATE_POWER_MANA) * (float)REGEN_CD * 0.001f; //regenTimer threshold / 1000
+    return add > 0 ? uint32(add) : 0;
+}
 
-            if (addvalue < 0.0f)
-            {
-                addvalue = 0.0f;
-            }
+// mana regenerated by one REGEN_CD tick
+uint32 BotAI::CalculateManaRegen() const
+{
+    if (m_bot->GetMaxPower(POWER_MANA) <= 1 ||
+        m_bot->GetPower(POWER_MANA) >= m_bot->GetMaxPower(POWER_MANA))
+    {
+        return 0;
+    }
 
-            m_bot->ModifyPower(POWER_MANA, int32(addvalue));
-        }
+    float addvalue;
+
+    if (m_bot->IsUnderLastManaUseEffect())
+    {
+        addvalue = m_bot->GetFloatValue(UNIT_FIELD_POWER_REGEN_INTERRUPTED_FLAT_MODIFIER);
+    }
+    else
+    {
+        addvalue = m_bot->GetFloatValue(UNIT_FIELD_POWER_REGEN_FLAT_MODIFIER);
     }
+
+    addvalue *= sWorld->getRate(RATE_POWER_MANA) * (float)REGEN_CD * 0.001f; //regenTimer threshold / 1000
+
+    return addvalue > 0.0f ? uint32(addvalue) : 0;
 }
 
 void BotAI::RegenerateEnergy()
@@ -2525,19 +2575,13 @@ void BotAI::RegenerateEnergy()
 
     if (curValue < maxValue)
     {
-        float addvalue = 0.01f * m_lastUpdateDiff * sWorld->getRate(RATE_POWER_ENERGY); //10 per sec
-        Unit::AuraEffectList const& ModPowerRegenPCTAuras = m_bot->GetAuraEffectsByType(SPELL_AURA_MOD_POWER_REGEN_PERCENT);
-
-        for (Unit::AuraEffectList::const_iterator i = ModPowerRegenPCTAuras.begin();
-             i != ModPowerRegenPCTAuras.end();
-             ++i)
+        if (m_isRegenAuraCacheDirty)
         {
-            if (Powers((*i)->GetMiscValue()) == POWER_ENERGY)
-            {
-                AddPct(addvalue, (*i)->GetAmount());
-            }
+            UpdateRegenAuraCache();
         }
 
+        float addvalue = 0.01f * m_lastUpdateDiff * sWorld->getRate(RATE_POWER_ENERGY); //10 per sec
+        addvalue *= m_energyRegenMult;
         addvalue += m_energyFraction;
 
         if (addvalue == 0x0) //only if world rate for enegy is 0
@@ -2567,7 +2611,47 @@ void BotAI::RegenerateEnergy()
         {
             m_bot->UpdateUInt32Value((uint16)UNIT_FIELD_POWER1 + (uint32)POWER_ENERGY, curValue);
         }
+
+        ++m_regenFieldWrites;
+    }
+}
+
+// auras which change the totals cached by UpdateRegenAuraCache()
+bool BotAI::IsRegenAura(uint32 auraname)
+{
+    return auraname == SPELL_AURA_MOD_POWER_REGEN_PERCENT ||
+        auraname == SPELL_AURA_MOD_HEALTH_REGEN_PERCENT ||
+        auraname == SPELL_AURA_MOD_REGEN ||
+        auraname == SPELL_AURA_MOD_REGEN_DURING_COMBAT ||
+        auraname == SPELL_AURA_MOD_HEALTH_REGEN_IN_COMBAT;
+}
+
+void BotAI::UpdateRegenAuraCache() const
+{
+    m_energyRegenMult = 1.f;
+
+    for (AuraEffect const* aurEff : m_bot->GetAuraEffectsByType(SPELL_AURA_MOD_POWER_REGEN_PERCENT))
+    {
+        if (Powers(aurEff->GetMiscValue()) == POWER_ENERGY)
+        {
+            AddPct(m_energyRegenMult, aurEff->GetAmount());
+        }
+    }
+
+    m_healthRegenMult = 1.f;
+
+    for (AuraEffect const* aurEff : m_bot->GetAuraEffectsByType(SPELL_AURA_MOD_HEALTH_REGEN_PERCENT))
+    {
+        AddPct(m_healthRegenMult, aurEff->GetAmount());
     }
+
+    m_healthRegenMod = m_bot->GetTotalAuraModifier(SPELL_AURA_MOD_REGEN);
+    m_healthRegenInCombatPct = m_bot->GetTotalAuraModifier(SPELL_AURA_MOD_REGEN_DURING_COMBAT);
+    m_healthRegenInCombatMod = m_bot->GetTotalAuraModifier(SPELL_AURA_MOD_HEALTH_REGEN_IN_COMBAT);
+    m_hasHealthRegenInCombatPct = m_bot->HasAuraType(SPELL_AURA_MOD_REGEN_DURING_COMBAT);
+    m_hasHealthRegenInCombatMod = m_bot->HasAuraType(SPELL_AURA_MOD_HEALTH_REGEN_IN_COMBAT);
+
+    m_isRegenAuraCacheDirty = false;
 }
 
 bool BotAI::CCed(Unit const* target, bool root)
@@ -2587,12 +2671,13 @@ void BotAI::DrinkPotion(bool mana)
 
 bool BotAI::IsPotionReady() const
 {
-    return m_potionTimer <= m_lastUpdateDiff;
+    return !m_isPotionCooldownPending && IsTimeReached(m_potionReadyTime);
 }
 
+// the cooldown itself starts in UpdateCommonTimers(...) once the bot left combat
 void BotAI::StartPotionTimer()
 {
-    m_potionTimer = POTION_CD;
+    m_isPotionCooldownPending = true;
 }
 
 uint32 BotAI::GetPotion(bool mana) const
@@ -2646,7 +2731,7 @@ void BotAI::BotStopMovement()
 // Movement set
 // Uses MovePoint() for following instead of MoveFollow()
 // This helps bots overcome a bug with fanthom walls on grid borders blocking pathing
-void BotAI::BotMovement(BotMovementType type, Position const* pos, Unit* target, bool generatePath) const
+void BotAI::BotMovement(BotMovementType type, Position const* pos, Unit* target, bool generatePath)
 {
     Vehicle* veh = m_bot->GetVehicle();
     VehicleSeatEntry const* seat = veh ? veh->GetSeatForPassenger(m_bot) : nullptr;
@@ -2664,6 +2749,27 @@ void BotAI::BotMovement(BotMovementType type, Position const* pos, Unit* target,
             mover->GetMotionMaster()->MoveChase(target);
             break;
         case BOT_MOVE_POINT:
+            if (generatePath && UpdateMapData() && m_mapData->GetMap() == mover->FindMap())
+            {
+                // MovePoint() would compute a new path, reuse one from the map cache
+                Movement::PointsArray path;
+
+                if (m_mapData->GetPathCache().GetPath(mover, *pos, path))
+                {
+                    // the escort generator paths a two point spline on its own, keep it straight
+                    if (path.size() == 2)
+                    {
+                        path.insert(path.begin() + 1, (path.front() + path.back()) * 0.5f);
+                    }
+
+                    // active slot, as MovePoint(): a follow generator below takes over when it ends
+                    mover->GetMotionMaster()->MoveSplinePath(&path);
+                    m_formationPath = false;
+                    break;
+                }
+            }
+
+            // no cache, or no path to reuse: the point generator paths on its own
             mover->GetMotionMaster()->MovePoint(mover->GetMapId(), *pos, generatePath);
             break;
         default:
@@ -2743,6 +2849,7 @@ bool BotAI::BotFinishTeleport()
             {
                 if (gr->IsMember(m_bot->GetGUID()))
                 {
+                    RecordGroupUpdateTraffic(gr);
                     gr->SendUpdate();
                 }
             }
@@ -2791,6 +2898,8 @@ bool BotAI::DoCastSpell(Unit* victim, uint32 spellId, bool triggered)
 
 bool BotAI::DoCastSpell(Unit* victim, uint32 spellId, TriggerCastFlags flags)
 {
+    BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_CAST);
+
     if (spellId == 0)
     {
         return false;
@@ -2978,13 +3087,7 @@ bool BotAI::DoCastSpell(Unit* victim, uint32 spellId, TriggerCastFlags flags)
         }
     }
 
-    m_gcdTimer = uint32(gcd);
-
-    //global cd cannot be less than 1000 ms
-    m_gcdTimer = std::max<uint32>(m_gcdTimer, 1000);
-
-    //global cd cannot be greater than 1500 ms
-    m_gcdTimer = std::min<uint32>(m_gcdTimer, 1500);
+    SetGlobalCooldown(uint32(gcd));
 
     return true;
 }
@@ -8,13 +8,21 @@
 #define _BOT_AI_H
 
 #include "BotCommon.h"
+#include "BotHandle.h"
+#include "BotPartyStats.h"
+#include "BotRandom.h"
 #include "EventProcessor.h"
 #include "ScriptedCreature.h"
 #include "Player.h"
 
+class BotMapData;
+class BotProfiler;
+class Group;
+
 class BotAI : public ScriptedAI
 {
     friend class BotMgr;
+    friend class BotRegenBatch;
 
 protected:
     explicit BotAI(Creature* creature);
@@ -25,14 +33,17 @@ public:
 private:
     struct BotSpell
     {
-        explicit BotSpell() : spellId(0), cooldown(0), enabled(true) { }
+        explicit BotSpell() : spellId(0), readyTime(0), enabled(true) { }
 
         uint32 spellId;
-        uint32 cooldown;
+        uint32 readyTime;   // bot time the cooldown ends at
         bool enabled;
+    };
 
-    private:
-        BotSpell(BotSpell const&);
+    struct BotSpellIndex
+    {
+        uint32 basespell;
+        uint32 slot;
     };
 
 public:
@@ -42,10 +53,22 @@ public:
     Creature* GetPet() const { return m_pet; }
     ObjectGuid GetLeaderGUID() const { return m_uiLeaderGUID; }
     void SetLeaderGUID(ObjectGuid leaderGUID) { m_uiLeaderGUID = leaderGUID; }
+    BotHandle GetBotHandle() const { return m_handle; }
+    void SetBotHandle(BotHandle handle) { m_handle = handle; }
+    BotRandom const& GetRandom() const { return m_random; }
+    void SetRandom(BotRandom const& random) { m_random = random; }
+    void SeedRandom(uint32 slot);
     uint32 GetBotSpellId(uint32 basespell) const;
+    uint32 GetBotSpellIdBySlot(uint32 slot) const;
     virtual uint32 GetBotClass() const;
+    uint32 GetRealBotClass() const { return m_botClass; }
     virtual uint8 GetBotStance() const;
     float GetTotalBotStat(uint8 stat) const;
+    void SetBotSpec(uint8 spec);
+    void InvalidateStatCache() { m_isStatCacheDirty = true; }
+    static bool IsStatAura(uint32 auraname);
+    void InvalidateRegenAuraCache() { m_isRegenAuraCacheDirty = true; }
+    static bool IsRegenAura(uint32 auraname);
 
 public:
     void MovementInform(uint32 motionType, uint32 pointId) override;
@@ -53,6 +76,7 @@ public:
     void MoveInLineOfSight(Unit*) override;
     void EnterEvadeMode(EvadeReason why = EVADE_REASON_OTHER) override;
     void EnterCombat(Unit* /*victim*/) override;
+    void DamageTaken(Unit* /*attacker*/, uint32& /*damage*/, DamageEffectType /*damagetype*/, SpellSchoolMask /*damageSchoolMask*/) override;
     void JustDied(Unit*) override;
     void JustRespawned() override;
     void UpdateAI(uint32) override;
@@ -61,6 +85,9 @@ public:
 
 public:
     bool OnBeforeCreatureUpdate(uint32 uiDiff);
+    void OnThinkTickGranted(uint32 token);
+    void PromoteLOD();
+    uint8 GetLODTier() const { return m_lodTier; }
     void OnBotOwnerMoveWorldport(Player* owner);
     void OnBotSpellGo(Spell const* spell, bool ok = true);
     void OnBotOwnerLevelChanged(uint8 /*newLevel*/, bool showLevelChange = true);
@@ -72,23 +99,38 @@ public:
     void SetFollowComplete();
     void BotStopMovement();
     Unit* GetLeaderForFollower();
-    void BotMovement(BotMovementType type, Position const* pos, Unit* target = nullptr, bool generatePath = true) const;
+    void BotMovement(BotMovementType type, Position const* pos, Unit* target = nullptr, bool generatePath = true);
 
     bool HasBotState(uint32 uiBotState) { return (m_uiBotState & uiBotState); }
     bool IAmFree() const;
     bool IsChanneling(Unit const* u = nullptr) const { if (!u) u = m_bot; return u->GetCurrentSpell(CURRENT_CHANNELED_SPELL); }
     bool IsCasting(Unit const* u = nullptr) const { if (!u) u = m_bot; return (u->HasUnitState(UNIT_STATE_CASTING) || IsChanneling(u) || u->IsNonMeleeSpellCast(false, false, true, false, false)); }
-    bool IsSpellReady(uint32 basespell, uint32 diff, bool checkGCD = true) const;
+    bool IsSpellReady(uint32 basespell, bool checkGCD = true) const;
+    bool IsSpellSlotReady(uint32 slot, bool checkGCD = true) const;
     bool CanBotAttackOnVehicle() const;
     bool CCed(Unit const* target, bool root = false);
+    uint32 CalculateHealthRegen() const;
+    uint32 CalculateManaRegen() const;
     static bool IsHeroExClass(uint8 botClass);
     bool JumpingOrFalling() const;
     bool Jumping() const;
 
     void SetGlobalCooldown(uint32 gcd);
     void SetSpellCooldown(uint32 basespell, uint32 msCooldown);
+    void SetSpellSlotCooldown(uint32 slot, uint32 msCooldown);
     void ReduceSpellCooldown(uint32 basespell, uint32 uiDiff);
 
+    // Per-bot clock in ms, advanced on every creature update. Timers are stored as
+    // absolute deadlines on it, so checking one is a single compare and nothing
+    // counts down per tick. The clock starts with the AI and does not wrap within
+    // 49 days.
+    uint32 GetBotTime() const { return m_botTime; }
+    bool IsTimeReached(uint32 deadline) const { return m_botTime >= deadline; }
+    bool IsGCDReady() const { return IsTimeReached(m_gcdReadyTime); }
+    // earliest time any spell can be cast: gcd end or first cooldown end, whichever is later.
+    // may come early (never late) after a cooldown was set.
+    uint32 GetNextSpellWakeTime();
+
     Unit* FindAOETarget(float dist, uint32 minTargetNum = 3) const;
     Unit* FindStunTarget(float dist = 20) const;
     Unit* FindCastingTarget(float maxdist = 10, float mindist = 0, uint32 spellId = 0, uint8 minHpPct = 0) const;
@@ -104,19 +146,23 @@ public:
 public:
     uint16 Rand() const;
 
-    typedef std::unordered_map<uint32 /*firstrankspellid*/, BotSpell* /*spell*/> BotSpellMap;
-    BotSpellMap const& GetSpellMap() const { return m_spells; }
+    // spells by slot. slots below the class slot count are fixed per class (see
+    // InitCustomeSpells), spells learned later by id get the next free slot.
+    typedef std::vector<BotSpell> BotSpellBook;
+    BotSpellBook const& GetSpellBook() const { return m_spellBook; }
 
 protected:
     virtual void UpdateBotCombatAI(uint32 uiDiff);
-    virtual void UpdateSpellCD(uint32 /*uiDiff*/) { }
     virtual void InitCustomeSpells() { }
 
     void UpdateCommonTimers(uint32 uiDiff);
     bool UpdateCommonBotAI(uint32 uiDiff);
-    void BuildGrouUpdatePacket(WorldPacket* data);
+    uint32 PublishPartyStats(Group const* grp, bool full = false);
 
+    void InitSpellBook(uint32 slotCount);
+    void InitSpellSlot(uint32 slot, uint32 basespell, bool forceadd = false, bool forwardRank = true);
     void InitSpellMap(uint32 basespell, bool forceadd = false, bool forwardRank = true);
+    int32 FindSpellSlot(uint32 basespell) const;
     static uint8 GetHealthPCT(Unit const* u) { if (!u || !u->IsAlive() || u->GetMaxHealth() <= 1) return 100; return uint8(((float(u->GetHealth())) / u->GetMaxHealth()) * 100); }
     static uint8 GetManaPCT(Unit const* u) { if (!u || !u->IsAlive() || u->GetMaxPower(POWER_MANA) <= 1) return 100; return (u->GetPower(POWER_MANA) * 10 / (1 + u->GetMaxPower(POWER_MANA) / 10)); }
 
@@ -133,6 +179,9 @@ protected:
 
     bool AssistPlayerInCombat(Unit* who);
 
+    // phase timings of the bot's map, null until the bot was updated on it
+    BotProfiler* GetProfiler() const;
+
     bool DoCastSpell(Unit* victim, uint32 spellId, bool triggered = false);
     bool DoCastSpell(Unit* victim, uint32 spellId, TriggerCastFlags flags);
     SpellCastResult CheckBotCast(Unit const* victim, uint32 spellId) const;
@@ -140,15 +189,27 @@ protected:
 
 private:
     void UpdateFollowerAI(uint32 uiDiff);
+    void UpdateFormation();
+    void MoveFollowLeader(Unit* leader);
     void UpdateBotRations();
+    bool WantsToDrink() const;
+    bool WantsToEat() const;
     void UpdateMountedState();
     void UpdateStandState() const;
+    void LowerSpellReadyTime(uint32 readyTime, bool mayRaise);
+    void RescanSpellReadyTime();
     void OnManaUpdate() const;
     void OnManaRegenUpdate() const;
     void AddBotState(uint32 uiBotState) { m_uiBotState |= uiBotState; }
     void RemoveBotState(uint32 uiBotState) { m_uiBotState &= ~uiBotState; }
-    bool DelayUpdateIfNeeded();
-    void GenerateRand() const;
+    bool UpdateLOD(uint32& uiDiff);
+    uint8 CalculateLODTier() const;
+    BotMapData* UpdateMapData();
+    void RecordGroupUpdateTraffic(Group const* group);
+    bool ConsumeThinkTick();
+    uint32 GetThinkInterval();
+    uint8 GetThinkPriority() const;
+    void GenerateRand();
     void Regenerate();
     void RegenerateEnergy();
 
@@ -160,34 +221,105 @@ protected:
     // leader guid of follower
     ObjectGuid m_uiLeaderGUID;
 
+    // registry handle, empty while the bot is not registered
+    BotHandle m_handle;
+
     // events process
     EventProcessor Events;
 
     // timer
-    uint32 m_gcdTimer;
+    uint32 m_botTime;
+    uint32 m_gcdReadyTime;
     uint32 m_lastUpdateDiff;
-    uint32 m_potionTimer;
+    uint32 m_potionReadyTime;
+    bool m_isPotionCooldownPending;     // potion cooldown starts once out of combat
+    // lower bound of the first cooldown end. cooldowns set after the last rescan
+    // may have moved the real one later, the book is rescanned once the bound is reached.
+    uint32 m_spellReadyTime;
+    bool m_isSpellReadyTimeStale;
 
     uint32 m_botClass;
     CreatureBaseStats const* m_classLevelInfo;
     uint8 m_botSpec;
 
 private:
+    float CalculateTotalBotStat(uint8 stat) const;
+    void UpdateStatCache() const;
+    void UpdateRegenAuraCache() const;
+
     // timer
-    uint32 m_uiFollowerTimer;
-    uint32 m_uiWaitTimer;
-    uint32 m_uiUpdateTimerMedium;
+    uint32 m_followerTime;
+    uint32 m_formationTime;
+
+    // follow offset last given to the follow generator, see UpdateFormation()
+    float m_formationDist;
+    float m_formationAngle;
+    // the escort generator moves along the formation path, not a BotMovement(...) path
+    bool m_formationPath;
+    uint32 m_groupUpdateTime;
+
+    // party frame values last sent to the group, see PublishPartyStats(...)
+    BotPartyStats m_partyStatsSent;
+    uint32 m_partyStatsFullTime;
+    uint32 m_partyStatsGroupSize;
     uint32 m_regenTimer;
 
+    // per-map bot data of the map the bot is on (m_dataMap), see BotMapData
+    Map* m_dataMap;
+    BotMapData* m_mapData;
+
+    // think scheduling, see BotScheduler
+    uint32 m_thinkToken;
+    uint8 m_thinkState;
+
+    // level of detail
+    uint8 m_lodTier;
+    uint32 m_lodCheckTimer;
+    uint32 m_lodSkippedDiff;
+
+    // per-bot random state, Rand() returns the value rolled for the current think tick
+    BotRandom m_random;
+    uint16 m_rand;
+
     float m_energyFraction;
+
+    // health / power field writes since the last REGEN_CD tick, see BotTrafficMgr
+    uint32 m_regenFieldWrites;
     uint32 m_uiBotState;
 
-    BotSpellMap m_spells;
+    BotSpellBook m_spellBook;
+
+    // (first rank spell id, slot) sorted by spell id, for lookups by spell id
+    std::vector<BotSpellIndex> m_spellIndex;
 
     bool m_isDoUpdateMana;
     bool m_isFeastMana;
     bool m_isFeastHealth;
 
+    // drink / food auras to remove when the bot stops feasting, 0 for none
+    uint32 m_feastManaSpellId;
+    uint32 m_feastHealthSpellId;
+
+    uint8 m_rationState;
+    uint32 m_rationTime;
+
+    // cached GetTotalBotStat() values, rebuilt on the first read after
+    // InvalidateStatCache() or after a stance change
+    mutable float m_statCache[MAX_BOT_ITEM_MOD];
+    mutable uint8 m_statCacheStance;
+    mutable bool m_isStatCacheDirty;
+
+    // aura totals used by Regenerate(), rebuilt on the first read after
+    // InvalidateRegenAuraCache()
+    mutable bool m_isRegenAuraCacheDirty;
+    mutable float m_energyRegenMult;            // SPELL_AURA_MOD_POWER_REGEN_PERCENT (energy)
+    mutable float m_healthRegenMult;            // SPELL_AURA_MOD_HEALTH_REGEN_PERCENT
+    mutable int32 m_healthRegenMod;             // SPELL_AURA_MOD_REGEN
+    mutable int32 m_healthRegenInCombatPct;     // SPELL_AURA_MOD_REGEN_DURING_COMBAT
+    mutable int32 m_healthRegenInCombatMod;     // SPELL_AURA_MOD_HEALTH_REGEN_IN_COMBAT
+    mutable bool m_hasHealthRegenInCombatPct;
+    mutable bool m_hasHealthRegenInCombatMod;
+
     //stats
     float m_hit, m_parry, m_dodge, m_block, m_crit, m_dmgTakenPhy, m_dmgTakenMag, m_armorPen;
     uint32 m_expertise, m_spellPower, m_spellPen, m_defense, m_blockValue;
@@ -127,6 +127,8 @@ enum BotCommonValues : uint32
 // COMMON CDs
     POTION_CD                           = 60000,    //default 60sec potion cd
     REGEN_CD                            = 1000,     // update hp/mana every X milliseconds
+    RATION_CD                           = 1000,     // check if the bot wants to eat or drink every X milliseconds
+    FORMATION_CD                        = 500,      // check the formation slot of followers every X milliseconds
 
 // ADVANCED
     COSMETIC_TELEPORT_EFFECT            = 52096,    //visual instant cast omni
@@ -297,6 +299,30 @@ enum BotMovementType
     BOT_MOVE_CHASE
 };
 
+// how often the bot update pipeline runs, see BotAI::UpdateLOD(...)
+enum BotLODTier
+{
+    BOT_LOD_FULL                        = 0,    // every update: in combat or near a player
+    BOT_LOD_REDUCED                     = 1,    // out of combat and far from every player
+    BOT_LOD_PARKED                      = 2     // no players on the map
+};
+
+// eat / drink decision, see BotAI::UpdateBotRations()
+enum BotRationState
+{
+    BOT_RATION_IDLE                     = 0,    // checks every RATION_CD if the bot is hungry or thirsty
+    BOT_RATION_PENDING                  = 1     // reacting, eats and/or drinks when the delay ends
+};
+
+// slots of the followers of one leader, see BotFormations
+enum BotFormationType
+{
+    BOT_FORMATION_NONE                  = 0,    // MoveFollow(leader, BOT_FOLLOW_DIST, BOT_FOLLOW_ANGLE) for every bot
+    BOT_FORMATION_LINE                  = 1,    // single file behind the leader
+    BOT_FORMATION_WEDGE                 = 2,    // V behind the leader
+    BOT_FORMATION_CIRCLE                = 3     // evenly around the leader
+};
+
 #define FROM_ARRAY(arr) arr, arr + sizeof(arr) / sizeof(arr[0])
 
 #endif // _BOT_COMMON_H
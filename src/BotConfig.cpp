@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotConfig.h"
+#include "BotCommon.h"
+#include "Config.h"
+#include "Log.h"
+
+BotConfig::BotConfig()
+{
+    m_registrySummaryInterval = 300;
+
+    m_schedulerThinkBudget = 8;
+
+    m_lodEnabled = true;
+    m_lodFullRateDistance = 100.f;
+    m_lodReducedInterval = 1000;
+    m_lodParkedInterval = 5000;
+
+    m_aiRandomSeed = 0;
+
+    m_regenBatchEnabled = true;
+
+    m_partyStatsInterval = 500;
+    m_partyStatsCombatInterval = 250;
+    m_partyStatsIdleInterval = 2000;
+    m_partyStatsFastChangePct = 5;
+
+    m_trafficSummaryInterval = 300;
+
+    m_formationType = BOT_FORMATION_WEDGE;
+    m_formationSpacing = 2.5f;
+
+    m_pathCacheSize = 256;
+
+    m_selfCheckEnabled = false;
+}
+
+void BotConfig::Load()
+{
+    m_registrySummaryInterval = sConfigMgr->GetOption<uint32>("NpcBots.Registry.SummaryInterval", 300);
+
+    m_schedulerThinkBudget = sConfigMgr->GetOption<uint32>("NpcBots.Scheduler.ThinkBudget", 8);
+
+    m_lodEnabled = sConfigMgr->GetOption<bool>("NpcBots.LOD.Enable", true);
+    m_lodFullRateDistance = sConfigMgr->GetOption<float>("NpcBots.LOD.FullRateDistance", 100.f);
+    m_lodReducedInterval = sConfigMgr->GetOption<uint32>("NpcBots.LOD.ReducedInterval", 1000);
+    m_lodParkedInterval = sConfigMgr->GetOption<uint32>("NpcBots.LOD.ParkedInterval", 5000);
+
+    m_aiRandomSeed = sConfigMgr->GetOption<uint32>("NpcBots.AI.RandomSeed", 0);
+
+    m_regenBatchEnabled = sConfigMgr->GetOption<bool>("NpcBots.Regen.Batch", true);
+
+    m_partyStatsInterval = sConfigMgr->GetOption<uint32>("NpcBots.PartyStats.Interval", 500);
+    m_partyStatsCombatInterval = sConfigMgr->GetOption<uint32>("NpcBots.PartyStats.CombatInterval", 250);
+    m_partyStatsIdleInterval = sConfigMgr->GetOption<uint32>("NpcBots.PartyStats.IdleInterval", 2000);
+    m_partyStatsFastChangePct = sConfigMgr->GetOption<uint32>("NpcBots.PartyStats.FastChangePct", 5);
+
+    m_trafficSummaryInterval = sConfigMgr->GetOption<uint32>("NpcBots.Traffic.SummaryInterval", 300);
+
+    m_formationType = sConfigMgr->GetOption<uint32>("NpcBots.Formation.Type", BOT_FORMATION_WEDGE);
+    m_formationSpacing = sConfigMgr->GetOption<float>("NpcBots.Formation.Spacing", 2.5f);
+
+    if (m_formationType > BOT_FORMATION_CIRCLE)
+    {
+        LOG_ERROR("npcbots", "NpcBots.Formation.Type ({}) is invalid, using {}", m_formationType, uint32(BOT_FORMATION_WEDGE));
+        m_formationType = BOT_FORMATION_WEDGE;
+    }
+
+    m_pathCacheSize = sConfigMgr->GetOption<uint32>("NpcBots.PathCache.Size", 256);
+
+    m_selfCheckEnabled = sConfigMgr->GetOption<bool>("NpcBots.SelfCheck.Enable", false);
+
+    LOG_INFO(
+        "npcbots",
+        "npcbots config loaded. registry summary interval: {}s, think budget: {} bots/frame",
+        m_registrySummaryInterval,
+        m_schedulerThinkBudget);
+}
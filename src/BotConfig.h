@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_CONFIG_H
+#define _BOT_CONFIG_H
+
+#include "Define.h"
+
+// npcbots.conf values, (re)loaded by WorldHookScript::OnAfterConfigLoad(...)
+class BotConfig
+{
+protected:
+    explicit BotConfig();
+
+public:
+    static BotConfig* instance()
+    {
+        static BotConfig instance;
+        return &instance;
+    }
+
+public:
+    void Load();
+
+    // registry
+    uint32 GetRegistrySummaryInterval() const { return m_registrySummaryInterval; }
+
+    // scheduler
+    uint32 GetSchedulerThinkBudget() const { return m_schedulerThinkBudget; }
+
+    // level of detail
+    bool IsLODEnabled() const { return m_lodEnabled; }
+    float GetLODFullRateDistance() const { return m_lodFullRateDistance; }
+    uint32 GetLODReducedInterval() const { return m_lodReducedInterval; }
+    uint32 GetLODParkedInterval() const { return m_lodParkedInterval; }
+
+    // ai
+    uint32 GetAIRandomSeed() const { return m_aiRandomSeed; }
+
+    // regeneration
+    bool IsRegenBatchEnabled() const { return m_regenBatchEnabled; }
+
+    // party stats
+    uint32 GetPartyStatsInterval() const { return m_partyStatsInterval; }
+    uint32 GetPartyStatsCombatInterval() const { return m_partyStatsCombatInterval; }
+    uint32 GetPartyStatsIdleInterval() const { return m_partyStatsIdleInterval; }
+    uint32 GetPartyStatsFastChangePct() const { return m_partyStatsFastChangePct; }
+
+    // traffic
+    uint32 GetTrafficSummaryInterval() const { return m_trafficSummaryInterval; }
+
+    // formations
+    uint32 GetFormationType() const { return m_formationType; }
+    float GetFormationSpacing() const { return m_formationSpacing; }
+
+    // path cache
+    uint32 GetPathCacheSize() const { return m_pathCacheSize; }
+
+    // self check
+    bool IsSelfCheckEnabled() const { return m_selfCheckEnabled; }
+
+private:
+    uint32 m_registrySummaryInterval;
+
+    uint32 m_schedulerThinkBudget;
+
+    bool m_lodEnabled;
+    float m_lodFullRateDistance;
+    uint32 m_lodReducedInterval;
+    uint32 m_lodParkedInterval;
+
+    uint32 m_aiRandomSeed;
+
+    bool m_regenBatchEnabled;
+
+    uint32 m_partyStatsInterval;
+    uint32 m_partyStatsCombatInterval;
+    uint32 m_partyStatsIdleInterval;
+    uint32 m_partyStatsFastChangePct;
+
+    uint32 m_trafficSummaryInterval;
+
+    uint32 m_formationType;
+    float m_formationSpacing;
+
+    uint32 m_pathCacheSize;
+
+    bool m_selfCheckEnabled;
+};
+
+#define sBotConfig BotConfig::instance()
+
+#endif // _BOT_CONFIG_H
@@ -7,6 +7,7 @@
 #include "BotDreadlord.h"
 #include "BotEvents.h"
 #include "BotMgr.h"
+#include "BotProfiler.h"
 #include "Player.h"
 #include "ScriptedGossip.h"
 #include "SpellAuras.h"
@@ -16,8 +17,7 @@ BotDreadlordAI::BotDreadlordAI(Creature* creature) : BotAI(creature)
 {
     LOG_INFO("npcbots", "BotDreadlordAI::BotDreadlordAI (this: 0X{:016x}, name: {})", (unsigned long long)this, creature->GetName().c_str());
 
-    m_checkAuraTimer = 0;
-    m_potionTimer = 0;
+    m_checkAuraTime = 0;
 
     // dreadlord immunities
     m_bot->ApplySpellImmune(0, IMMUNITY_STATE, SPELL_AURA_MOD_POSSESS, true);
@@ -68,9 +68,10 @@ BotDreadlordAI::~BotDreadlordAI()
 
 void BotDreadlordAI::InitCustomeSpells()
 {
-    InitSpellMap(CARRION_SWARM_1, true, false);
-    InitSpellMap(SLEEP_1, true, false);
-    InitSpellMap(INFERNO_1, true, false);
+    InitSpellBook(DREADLORD_SLOT_MAX);
+    InitSpellSlot(DREADLORD_SLOT_CARRION_SWARM, CARRION_SWARM_1, true, false);
+    InitSpellSlot(DREADLORD_SLOT_SLEEP, SLEEP_1, true, false);
+    InitSpellSlot(DREADLORD_SLOT_INFERNO, INFERNO_1, true, false);
 
     SpellInfo* sinfo = nullptr;
 
@@ -237,23 +238,27 @@ void BotDreadlordAI::UpdateBotCombatAI(uint32 uiDiff)
     {
         return;
     }
-    
-    if (DoSummonInfernoIfReady(uiDiff))
-    {
-        return;
-    }
 
-    if (DoCastDreadlordSpellSleep(uiDiff))
+    // nothing can be cast before the gcd and the first cooldown are over
+    if (IsTimeReached(GetNextSpellWakeTime()))
     {
-        return;
+        if (DoSummonInfernoIfReady(uiDiff))
+        {
+            return;
+        }
+
+        if (DoCastDreadlordSpellSleep(uiDiff))
+        {
+            return;
+        }
     }
 
     DoDreadlordAttackIfReady(uiDiff);
 }
 
-bool BotDreadlordAI::DoSummonInfernoIfReady(uint32 uiDiff)
+bool BotDreadlordAI::DoSummonInfernoIfReady(uint32 /*uiDiff*/)
 {
-    bool isSpellReady = IsSpellReady(INFERNO_1, uiDiff);
+    bool isSpellReady = IsSpellSlotReady(DREADLORD_SLOT_INFERNO);
     bool isInCombat = m_bot->IsInCombat();
     bool hasMana = m_bot->GetPower(POWER_MANA) >= INFERNAL_COST;
 
@@ -284,17 +289,22 @@ bool BotDreadlordAI::DoSummonInfernoIfReady(uint32 uiDiff)
         }
 
         // dummy summon infernal
-        SpellCastResult result = m_bot->CastSpell(
-                                            m_infernoSpwanPos.m_positionX,
-                                            m_infernoSpwanPos.m_positionY,
-                                            m_infernoSpwanPos.m_positionZ,
-                                            INFERNO_1,
-                                            false);
+        SpellCastResult result;
+
+        {
+            BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_CAST);
+            result = m_bot->CastSpell(
+                                                m_infernoSpwanPos.m_positionX,
+                                                m_infernoSpwanPos.m_positionY,
+                                                m_infernoSpwanPos.m_positionZ,
+                                                INFERNO_1,
+                                                false);
+        }
 
         if (result == SPELL_FAILED_SUCCESS || result == SPELL_CAST_OK)
         {
             SetGlobalCooldown(sSpellMgr->GetSpellInfo(INFERNO_1)->StartRecoveryTime);
-            SetSpellCooldown(INFERNO_1, INFERNAL_CD);
+            SetSpellSlotCooldown(DREADLORD_SLOT_INFERNO, INFERNAL_CD);
 
             return true;
         }
@@ -303,9 +313,9 @@ bool BotDreadlordAI::DoSummonInfernoIfReady(uint32 uiDiff)
     return false;
 }
 
-bool BotDreadlordAI::DoCastDreadlordSpellSleep(uint32 diff)
+bool BotDreadlordAI::DoCastDreadlordSpellSleep(uint32 /*diff*/)
 {
-    bool isSpellReady = IsSpellReady(SLEEP_1, diff);
+    bool isSpellReady = IsSpellSlotReady(DREADLORD_SLOT_SLEEP);
     bool isInCombat = m_bot->IsInCombat();
     bool isCasting = IsCasting();
     bool hasMana = m_bot->GetPower(POWER_MANA) >= SLEEP_COST;
@@ -321,21 +331,26 @@ bool BotDreadlordAI::DoCastDreadlordSpellSleep(uint32 diff)
     float dist = DoGetSpellMaxRange(SLEEP_1);
 
     if (victim &&
-        IsSpellReady(CARRION_SWARM_1, diff) &&
+        IsSpellSlotReady(DREADLORD_SLOT_CARRION_SWARM) &&
         !CCed(victim) &&
         m_bot->GetDistance(victim) < dist &&
         (victim->IsNonMeleeSpellCast(false, false, true) ||
          (victim->IsInCombat() && victim->getAttackers().size() == 1)))
     {
-        SpellCastResult result = m_bot->CastSpell(
-                                            victim,
-                                            SLEEP_1,
-                                            false);
+        SpellCastResult result;
+
+        {
+            BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_CAST);
+            result = m_bot->CastSpell(
+                                                victim,
+                                                SLEEP_1,
+                                                false);
+        }
 
         if (result == SPELL_FAILED_SUCCESS || result == SPELL_CAST_OK)
         {
             SetGlobalCooldown(sSpellMgr->GetSpellInfo(SLEEP_1)->StartRecoveryTime);
-            SetSpellCooldown(SLEEP_1, SLEEP_CD);
+            SetSpellSlotCooldown(DREADLORD_SLOT_SLEEP, SLEEP_CD);
 
             return true;
         }
@@ -343,15 +358,20 @@ bool BotDreadlordAI::DoCastDreadlordSpellSleep(uint32 diff)
 
     if (Unit* target = FindCastingTarget(dist, 0, SLEEP_1))
     {
-        SpellCastResult result = m_bot->CastSpell(
-                                            target,
-                                            SLEEP_1,
-                                            false);
+        SpellCastResult result;
+
+        {
+            BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_CAST);
+            result = m_bot->CastSpell(
+                                                target,
+                                                SLEEP_1,
+                                                false);
+        }
 
         if (result == SPELL_FAILED_SUCCESS || result == SPELL_CAST_OK)
         {
             SetGlobalCooldown(sSpellMgr->GetSpellInfo(SLEEP_1)->StartRecoveryTime);
-            SetSpellCooldown(SLEEP_1, SLEEP_CD);
+            SetSpellSlotCooldown(DREADLORD_SLOT_SLEEP, SLEEP_CD);
 
             return true;
         }
@@ -359,15 +379,20 @@ bool BotDreadlordAI::DoCastDreadlordSpellSleep(uint32 diff)
 
     if (Unit* target = FindStunTarget(dist))
     {
-        SpellCastResult result = m_bot->CastSpell(
-                                            target,
-                                            SLEEP_1,
-                                            false);
+        SpellCastResult result;
+
+        {
+            BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_CAST);
+            result = m_bot->CastSpell(
+                                                target,
+                                                SLEEP_1,
+                                                false);
+        }
 
         if (result == SPELL_FAILED_SUCCESS || result == SPELL_CAST_OK)
         {
             SetGlobalCooldown(sSpellMgr->GetSpellInfo(SLEEP_1)->StartRecoveryTime);
-            SetSpellCooldown(SLEEP_1, SLEEP_CD);
+            SetSpellSlotCooldown(DREADLORD_SLOT_SLEEP, SLEEP_CD);
 
             return true;
         }
@@ -376,9 +401,9 @@ bool BotDreadlordAI::DoCastDreadlordSpellSleep(uint32 diff)
     return false;
 }
 
-void BotDreadlordAI::DoDreadlordAttackIfReady(uint32 uiDiff)
+void BotDreadlordAI::DoDreadlordAttackIfReady(uint32 /*uiDiff*/)
 {
-    bool isSpellReady = IsSpellReady(CARRION_SWARM_1, uiDiff);
+    bool isSpellReady = IsSpellSlotReady(DREADLORD_SLOT_CARRION_SWARM);
     bool isInCombat = m_bot->IsInCombat();
     bool hasMana = m_bot->GetPower(POWER_MANA) >= CARRION_COST;
     uint16 rand = Rand();
@@ -404,15 +429,20 @@ void BotDreadlordAI::DoDreadlordAttackIfReady(uint32 uiDiff)
         if (cast)
         {
             // carrion swarm
-            SpellCastResult result = m_bot->CastSpell(
-                                                m_bot,
-                                                GetBotSpellId(CARRION_SWARM_1),
-                                                false);
+            SpellCastResult result;
+
+            {
+                BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_CAST);
+                result = m_bot->CastSpell(
+                                                    m_bot,
+                                                    GetBotSpellIdBySlot(DREADLORD_SLOT_CARRION_SWARM),
+                                                    false);
+            }
 
             if (result == SPELL_FAILED_SUCCESS || result == SPELL_CAST_OK)
             {
                 SetGlobalCooldown(sSpellMgr->GetSpellInfo(CARRION_SWARM_1)->StartRecoveryTime);
-                SetSpellCooldown(CARRION_SWARM_1, CARRION_CD);
+                SetSpellSlotCooldown(DREADLORD_SLOT_CARRION_SWARM, CARRION_CD);
 
                 return;
             }
@@ -428,29 +458,34 @@ void BotDreadlordAI::OnClassSpellGo(SpellInfo const* spellInfo)
 
     if (baseId == INFERNO_1)
     {
-        SpellCastResult result = m_bot->CastSpell(
-                                            m_infernoSpwanPos.m_positionX,
-                                            m_infernoSpwanPos.m_positionY,
-                                            m_infernoSpwanPos.m_positionZ,
-                                            SPELL_INFERNO_METEOR_VISUAL,
-                                            true);
+        SpellCastResult result;
+
+        {
+            BOT_PROFILE_SCOPE(GetProfiler(), BOT_PROFILE_CAST);
+            result = m_bot->CastSpell(
+                                                m_infernoSpwanPos.m_positionX,
+                                                m_infernoSpwanPos.m_positionY,
+                                                m_infernoSpwanPos.m_positionZ,
+                                                SPELL_INFERNO_METEOR_VISUAL,
+                                                true);
+        }
 
         if (result == SPELL_FAILED_SUCCESS || result == SPELL_CAST_OK)
         {
-            DelayedSummonInfernoEvent* summonInfernoEvent = new DelayedSummonInfernoEvent(m_bot, m_infernoSpwanPos);
+            DelayedSummonInfernoEvent* summonInfernoEvent = new DelayedSummonInfernoEvent(m_handle, m_infernoSpwanPos);
             Events.AddEvent(summonInfernoEvent, Events.CalculateTime(500));
         }
     }
 }
 
-void BotDreadlordAI::CheckAura(uint32 uiDiff)
+void BotDreadlordAI::CheckAura(uint32 /*uiDiff*/)
 {
-    if (m_checkAuraTimer > uiDiff || m_gcdTimer > uiDiff || IsCasting())
+    if (!IsTimeReached(m_checkAuraTime) || !IsGCDReady() || IsCasting())
     {
         return;
     }
 
-    m_checkAuraTimer = 10000;
+    m_checkAuraTime = GetBotTime() + 10000;
 
     if (!m_bot->HasAura(VAMPIRIC_AURA, m_bot->GetGUID()))
     {
@@ -510,18 +545,6 @@ void BotDreadlordAI::RefreshAura(uint32 spellId, int8 count, Unit* target) const
     }
 }
 
-void BotDreadlordAI::UpdateSpellCD(uint32 uiDiff)
-{
-    if (m_checkAuraTimer > uiDiff)
-    {
-        m_checkAuraTimer -= uiDiff;
-    }
-
-    ReduceSpellCooldown(INFERNO_1, uiDiff);
-    ReduceSpellCooldown(SLEEP_1, uiDiff);
-    ReduceSpellCooldown(CARRION_SWARM_1, uiDiff);
-}
-
 // called by DelayedSummonInfernoEvent::Execute(...)
 void BotDreadlordAI::SummonBotPet(const Position *pos)
 {
@@ -581,14 +604,14 @@ void BotDreadlordAI::SummonBotPet(const Position *pos)
 
         m_pet = infernal;
 
-        DelayedUnsummonInfernoEvent* unsummonInfernoEvent = new DelayedUnsummonInfernoEvent(m_bot);
+        DelayedUnsummonInfernoEvent* unsummonInfernoEvent = new DelayedUnsummonInfernoEvent(m_handle);
         Events.AddEvent(unsummonInfernoEvent, Events.CalculateTime(INFERNAL_DURATION));
     }
     else
     {
         LOG_DEBUG("npcbots", "summon infernal servant faild...");
 
-        SetSpellCooldown(INFERNO_1, 0);
+        SetSpellSlotCooldown(DREADLORD_SLOT_INFERNO, 0);
     }
 }
 
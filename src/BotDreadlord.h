@@ -9,6 +9,7 @@
 
 #include "BotAI.h"
 #include "BotCommon.h"
+#include "BotMgr.h"
 #include "Creature.h"
 #include "Object.h"
 #include "ScriptedCreature.h"
@@ -30,6 +31,16 @@ enum DreadlordBaseSpells
     INFERNO_1               = SPELL_INFERNO
 };
 
+// spell book slots, see BotAI::InitSpellBook(...)
+enum DreadlordSpellSlots
+{
+    DREADLORD_SLOT_CARRION_SWARM    = 0,
+    DREADLORD_SLOT_SLEEP            = 1,
+    DREADLORD_SLOT_INFERNO          = 2,
+
+    DREADLORD_SLOT_MAX
+};
+
 enum DreadlordPassives
 {
     VAMPIRIC_AURA           = SPELL_VAMPIRIC_AURA,
@@ -67,52 +78,42 @@ private:
     class DelayedSummonInfernoEvent : public BasicEvent
     {
     public:
-        DelayedSummonInfernoEvent(Creature* bot, Position pos) : m_bot(bot), m_pos(pos) { }
+        DelayedSummonInfernoEvent(BotHandle handle, Position pos) : m_handle(handle), m_pos(pos) { }
 
     protected:
         bool Execute(uint64 /*e_time*/, uint32 /*p_time*/)
         {
-            if (m_bot)
+            if (BotDreadlordAI* ai = (BotDreadlordAI*)sBotsRegistry->ResolveBotAI(m_handle))
             {
-                BotDreadlordAI* ai = (BotDreadlordAI*)m_bot->AI();
-
-                if (ai)
-                {
-                    ai->SummonBotPet(&m_pos);
-                }
+                ai->SummonBotPet(&m_pos);
             }
 
             return true;
         }
 
     private:
-        Creature* m_bot;
+        BotHandle m_handle;
         Position m_pos;
     };
 
     class DelayedUnsummonInfernoEvent : public BasicEvent
     {
     public:
-        DelayedUnsummonInfernoEvent(Creature const* bot) : m_bot(bot) { }
+        DelayedUnsummonInfernoEvent(BotHandle handle) : m_handle(handle) { }
 
     protected:
         bool Execute(uint64 /*e_time*/, uint32 /*p_time*/)
         {
-            if (m_bot)
+            if (BotDreadlordAI* ai = (BotDreadlordAI*)sBotsRegistry->ResolveBotAI(m_handle))
             {
-                BotDreadlordAI* ai = (BotDreadlordAI*)m_bot->AI();
-
-                if (ai)
-                {
-                    ai->UnSummonBotPet();
-                }
+                ai->UnSummonBotPet();
             }
 
             return true;
         }
 
     private:
-        Creature const* m_bot;
+        BotHandle m_handle;
     };
 
 public:
@@ -129,7 +130,6 @@ public:
 
 protected:
     void UpdateBotCombatAI(uint32 uiDiff) override;
-    void UpdateSpellCD(uint32 uiDiff) override;
     void CheckAura(uint32 uiDiff);
     void RefreshAura(uint32 spellId, int8 count = 1, Unit* target = nullptr) const;
 
@@ -141,7 +141,7 @@ private:
     void DoDreadlordAttackIfReady(uint32 uiDiff);
 
 private:
-    uint32 m_checkAuraTimer;
+    uint32 m_checkAuraTime;
     Position m_infernoSpwanPos;
 };
 
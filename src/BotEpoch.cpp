@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotEpoch.h"
+#include "Errors.h"
+
+#include <limits>
+
+struct BotEpoch::ThreadReader
+{
+    Reader* reader = nullptr;
+
+    ~ThreadReader()
+    {
+        if (reader)
+        {
+            reader->depth = 0;
+            reader->epoch.store(0, std::memory_order_release);
+            reader->inUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+BotEpoch::Reader* BotEpoch::GetThreadReader()
+{
+    static thread_local ThreadReader threadReader;
+
+    if (!threadReader.reader)
+    {
+        threadReader.reader = AcquireReader();
+    }
+
+    return threadReader.reader;
+}
+
+BotEpoch::Reader* BotEpoch::AcquireReader()
+{
+    // reuse the record of a thread which exited
+    for (Reader* reader = m_readers.load(std::memory_order_acquire); reader != nullptr; reader = reader->next)
+    {
+        bool expected = false;
+
+        if (!reader->inUse.load(std::memory_order_relaxed) &&
+            reader->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+        {
+            return reader;
+        }
+    }
+
+    Reader* reader = new Reader();
+    reader->inUse.store(true, std::memory_order_relaxed);
+    reader->next = m_readers.load(std::memory_order_relaxed);
+
+    while (!m_readers.compare_exchange_weak(reader->next, reader, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+
+    return reader;
+}
+
+void BotEpoch::Enter()
+{
+    Reader* reader = GetThreadReader();
+
+    if (reader->depth++ == 0)
+    {
+        // seq_cst: the pin is visible to Reclaim() before the reader loads any pointer
+        reader->epoch.store(m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+}
+
+void BotEpoch::Exit()
+{
+    Reader* reader = GetThreadReader();
+
+    ASSERT(reader->depth > 0);
+
+    if (--reader->depth == 0)
+    {
+        reader->epoch.store(0, std::memory_order_release);
+    }
+}
+
+void BotEpoch::Retire(std::function<void()> deleter)
+{
+    // readers which pinned this epoch or an older one may still see the old data
+    uint64 epoch = m_epoch.fetch_add(1, std::memory_order_seq_cst);
+
+    lock();
+    m_retired.emplace_back(epoch, std::move(deleter));
+    unlock();
+
+    Reclaim();
+}
+
+void BotEpoch::Reclaim()
+{
+    uint64 oldest = std::numeric_limits<uint64>::max();
+
+    for (Reader* reader = m_readers.load(std::memory_order_acquire); reader != nullptr; reader = reader->next)
+    {
+        uint64 epoch = reader->epoch.load(std::memory_order_seq_cst);
+
+        if (epoch && epoch < oldest)
+        {
+            oldest = epoch;
+        }
+    }
+
+    std::vector<std::function<void()>> ready;
+
+    lock();
+
+    for (size_t i = 0; i < m_retired.size();)
+    {
+        if (m_retired[i].first < oldest)
+        {
+            ready.push_back(std::move(m_retired[i].second));
+            m_retired[i] = std::move(m_retired.back());
+            m_retired.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    unlock();
+
+    // outside the lock, a deleter may retire more data
+    for (std::function<void()>& deleter : ready)
+    {
+        deleter();
+    }
+}
+
+uint32 BotEpoch::GetRetiredCount()
+{
+    lock();
+    uint32 count = uint32(m_retired.size());
+    unlock();
+
+    return count;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_EPOCH_H
+#define _BOT_EPOCH_H
+
+#include "Define.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Epoch based reclamation for read-mostly shared data (BotsRegistry snapshots).
+// A reader pins the global epoch in its own per-thread record while it looks at
+// shared memory, a writer retires the memory it replaced together with the
+// epoch it was replaced in. Retired memory is freed once every pinned reader
+// pinned a later epoch. Pinning is a store to the reader's own cache line:
+// readers never lock and never write memory shared with other readers.
+class BotEpoch
+{
+protected:
+    explicit BotEpoch() : m_epoch(1), m_readers(nullptr) { }
+
+public:
+    static BotEpoch* instance()
+    {
+        static BotEpoch instance;
+        return &instance;
+    }
+
+public:
+    // may nest, only the outermost Enter() / Exit() pair pins the thread
+    void Enter();
+    void Exit();
+
+    // call after the pointer to the replaced data was swapped out, deleter frees it
+    void Retire(std::function<void()> deleter);
+
+    // frees what no reader can see anymore, called by Retire() and once per world update
+    void Reclaim();
+
+    uint32 GetRetiredCount();
+
+private:
+    struct alignas(64) Reader
+    {
+        std::atomic<uint64> epoch { 0 };    // pinned epoch, 0 while the thread is not reading
+        std::atomic<bool> inUse { false };  // owned by a live thread
+        Reader* next = nullptr;             // readers are never freed, only reused
+        uint32 depth = 0;                   // Enter() nesting, owner thread only
+    };
+
+    // releases the reader of a thread when it exits
+    struct ThreadReader;
+
+    Reader* GetThreadReader();
+    Reader* AcquireReader();
+
+    void lock()
+    {
+        m_retireLock.lock();
+    }
+
+    void unlock()
+    {
+        m_retireLock.unlock();
+    }
+
+private:
+    std::atomic<uint64> m_epoch;
+    std::atomic<Reader*> m_readers;
+
+    std::mutex m_retireLock;
+    std::vector<std::pair<uint64, std::function<void()>>> m_retired;
+};
+
+#define sBotEpoch BotEpoch::instance()
+
+// pins the calling thread for the lifetime of the guard
+class BotEpochGuard
+{
+public:
+    BotEpochGuard() { sBotEpoch->Enter(); }
+    ~BotEpochGuard() { sBotEpoch->Exit(); }
+
+    BotEpochGuard(BotEpochGuard const&) = delete;
+    BotEpochGuard& operator=(BotEpochGuard const&) = delete;
+};
+
+#endif // _BOT_EPOCH_H
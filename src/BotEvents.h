@@ -7,6 +7,8 @@
 #ifndef _BOT_EVENTS_H
 #define _BOT_EVENTS_H
 
+#include "BotAI.h"
+#include "BotMgr.h"
 #include "EventProcessor.h"
 
 class TeleportFinishEvent : public BasicEvent
@@ -15,17 +17,22 @@ class TeleportFinishEvent : public BasicEvent
     friend class BotMgr;
 
     protected:
-        TeleportFinishEvent(BotAI* botAI) : m_botAI(botAI) {  }
+        TeleportFinishEvent(BotHandle handle) : m_handle(handle) {  }
         ~TeleportFinishEvent() {  }
 
-        // Execute is always called while creature is out of world so ai is never deleted
+        // resolves to nothing if the bot was unregistered in the meantime
         bool Execute(uint64 /*e_time*/, uint32 /*p_time*/)
         {
-            return m_botAI->BotFinishTeleport();
+            if (BotAI* botAI = sBotsRegistry->ResolveBotAI(m_handle))
+            {
+                return botAI->BotFinishTeleport();
+            }
+
+            return true;
         }
 
     private:
-        BotAI* m_botAI;
+        BotHandle m_handle;
 };
 
 #endif  //_BOT_EVENTS_H
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotFormations.h"
+#include "BotCommon.h"
+#include "BotConfig.h"
+#include "Creature.h"
+#include "Map.h"
+#include "MoveSpline.h"
+#include "PathGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+// the leader moved this far from the end of its path, compute a new one
+#define BOT_FORMATION_REPATH_DIST 4.0f
+// the bot is in its slot
+#define BOT_FORMATION_SLOT_DIST 1.5f
+// max distance from the bot to the point where it joins the leader path
+#define BOT_FORMATION_JOIN_DIST 10.0f
+// max height difference between a slot and the leader
+#define BOT_FORMATION_SLOT_HEIGHT 5.0f
+// slots of bots which did not ask for their slot for this long (ms) are freed
+#define BOT_FORMATION_SLOT_EXPIRE 5000
+
+BotFormations::BotFormations(Map* map) : m_map(map), m_time(0)
+{
+}
+
+void BotFormations::Update(uint32 diff)
+{
+    m_time += diff;
+
+    for (auto itr = m_formations.begin(); itr != m_formations.end();)
+    {
+        std::vector<Slot>& slots = itr->second.slots;
+
+        // the bots behind a freed slot move up
+        slots.erase(std::remove_if(slots.begin(), slots.end(), [this](Slot const& slot)
+        {
+            return m_time - slot.seenTime > BOT_FORMATION_SLOT_EXPIRE;
+        }), slots.end());
+
+        if (slots.empty())
+        {
+            itr = m_formations.erase(itr);
+        }
+        else
+        {
+            ++itr;
+        }
+    }
+}
+
+BotFormations::Slot& BotFormations::GetSlot(Formation& formation, Creature const* bot, uint32& index)
+{
+    // slots are given in the order the bots asked for them
+    auto itr = std::find_if(formation.slots.begin(), formation.slots.end(), [bot](Slot const& slot)
+    {
+        return slot.botGUID == bot->GetGUID();
+    });
+
+    if (itr == formation.slots.end())
+    {
+        formation.slots.push_back({ bot->GetGUID(), m_time, Position() });
+        itr = formation.slots.end() - 1;
+    }
+
+    itr->seenTime = m_time;
+    index = uint32(itr - formation.slots.begin());
+
+    return *itr;
+}
+
+bool BotFormations::GetSlotOffset(Unit const* leader, Creature const* bot, float& dist, float& angle)
+{
+    if (sBotConfig->GetFormationType() == BOT_FORMATION_NONE)
+    {
+        return false;
+    }
+
+    Formation& formation = m_formations[leader->GetGUID()];
+
+    uint32 index;
+    GetSlot(formation, bot, index);
+
+    return GetSlotOffset(index, uint32(formation.slots.size()), dist, angle);
+}
+
+BotFormationMove BotFormations::GetSlotMove(Unit const* leader, Creature const* bot, Movement::PointsArray& points)
+{
+    Formation& formation = m_formations[leader->GetGUID()];
+
+    uint32 index;
+    Slot& slot = GetSlot(formation, bot, index);
+
+    float dist;
+    float angle;
+    Position slotPos;
+
+    if (!GetSlotOffset(index, uint32(formation.slots.size()), dist, angle) ||
+        !GetSlotPosition(leader, dist, angle, slotPos))
+    {
+        return BOT_FORMATION_MOVE_FALLBACK;
+    }
+
+    if (bot->GetExactDist(&slotPos) <= BOT_FORMATION_SLOT_DIST)
+    {
+        return BOT_FORMATION_MOVE_NONE;
+    }
+
+    if (!bot->movespline->Finalized() && slot.target.GetExactDist(&slotPos) <= BOT_FORMATION_SLOT_DIST)
+    {
+        return BOT_FORMATION_MOVE_NONE;
+    }
+
+    UpdateLeaderPath(formation, leader);
+
+    Movement::PointsArray const& path = formation.path;
+    G3D::Vector3 const target(slotPos.GetPositionX(), slotPos.GetPositionY(), slotPos.GetPositionZ());
+
+    // join the leader path at its point nearest to the bot (the leader's own
+    // position excluded), or go straight to the slot if that is nearer
+    size_t join = path.size();
+    float joinDist = bot->GetExactDist(&slotPos);
+
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+    {
+        float const pointDist = bot->GetExactDist(path[i].x, path[i].y, path[i].z);
+
+        if (pointDist < joinDist)
+        {
+            join = i;
+            joinDist = pointDist;
+        }
+    }
+
+    if (joinDist > BOT_FORMATION_JOIN_DIST)
+    {
+        return BOT_FORMATION_MOVE_FALLBACK;
+    }
+
+    G3D::Vector3 const& first = join < path.size() ? path[join] : target;
+
+    if (!bot->IsWithinLOS(first.x, first.y, first.z))
+    {
+        return BOT_FORMATION_MOVE_FALLBACK;
+    }
+
+    // first point is replaced by the bot position on launch
+    points.clear();
+    points.push_back(G3D::Vector3(bot->GetPositionX(), bot->GetPositionY(), bot->GetPositionZ()));
+
+    if (join < path.size())
+    {
+        points.insert(points.end(), path.begin() + join, path.end() - 1);
+
+        // the slot is checked from the leader, go through its position if needed
+        G3D::Vector3 const& last = points.back();
+
+        if (!m_map->isInLineOfSight(
+            last.x, last.y, last.z + 2.f,
+            target.x, target.y, target.z + 2.f,
+            leader->GetPhaseMask(),
+            LINEOFSIGHT_ALL_CHECKS,
+            VMAP::ModelIgnoreFlags::Nothing))
+        {
+            points.push_back(path.back());
+        }
+    }
+
+    // the escort generator paths a two point spline on its own, keep it straight
+    if (points.size() == 1)
+    {
+        points.push_back((points.front() + target) * 0.5f);
+    }
+
+    points.push_back(target);
+
+    slot.target = slotPos;
+
+    return BOT_FORMATION_MOVE_PATH;
+}
+
+void BotFormations::UpdateLeaderPath(Formation& formation, Unit const* leader)
+{
+    G3D::Vector3 const leaderPos(leader->GetPositionX(), leader->GetPositionY(), leader->GetPositionZ());
+
+    if (formation.path.empty())
+    {
+        formation.path.push_back(leaderPos);
+        return;
+    }
+
+    G3D::Vector3 const start = formation.path.back();
+
+    if ((start - leaderPos).squaredLength() < BOT_FORMATION_REPATH_DIST * BOT_FORMATION_REPATH_DIST)
+    {
+        return;
+    }
+
+    // one path query for all followers of the leader
+    PathGenerator generator(leader);
+    generator.CalculatePath(start.x, start.y, start.z, leaderPos.x, leaderPos.y, leaderPos.z, false);
+
+    if (generator.GetPathType() & PATHFIND_NORMAL)
+    {
+        formation.path = generator.GetPath();
+    }
+    else
+    {
+        // no walkable path (teleport, flight...), followers go straight or find their own
+        formation.path.clear();
+        formation.path.push_back(leaderPos);
+    }
+}
+
+// the point at the follow offset, as the follow generator places it
+bool BotFormations::GetSlotPosition(Unit const* leader, float dist, float angle, Position& pos) const
+{
+    float const o = leader->GetOrientation() + angle;
+    float const x = leader->GetPositionX() + dist * std::cos(o);
+    float const y = leader->GetPositionY() + dist * std::sin(o);
+    float const z = m_map->GetHeight(leader->GetPhaseMask(), x, y, leader->GetPositionZ() + 2.f);
+
+    // no ground, a cliff or a wall between the leader and the slot
+    if (z <= INVALID_HEIGHT || std::fabs(z - leader->GetPositionZ()) > BOT_FORMATION_SLOT_HEIGHT)
+    {
+        return false;
+    }
+
+    if (!leader->IsWithinLOS(x, y, z))
+    {
+        return false;
+    }
+
+    pos.Relocate(x, y, z, leader->GetOrientation());
+
+    return true;
+}
+
+bool BotFormations::GetSlotOffset(uint32 slot, uint32 count, float& dist, float& angle)
+{
+    float const spacing = sBotConfig->GetFormationSpacing();
+
+    // offset in the leader frame
+    float forward = 0.f;
+    float left = 0.f;
+
+    switch (sBotConfig->GetFormationType())
+    {
+        case BOT_FORMATION_LINE:
+            forward = -spacing * (slot + 1);
+            break;
+        case BOT_FORMATION_WEDGE:
+        {
+            float const row = float(slot / 2 + 1);
+
+            forward = -spacing * row;
+            left = (slot % 2 ? -spacing : spacing) * row;
+            break;
+        }
+        case BOT_FORMATION_CIRCLE:
+        {
+            float const radius = std::max<float>(BOT_FOLLOW_DIST, spacing * count / float(2 * M_PI));
+            float const slotAngle = float(M_PI + 2 * M_PI * slot / count);
+
+            forward = radius * std::cos(slotAngle);
+            left = radius * std::sin(slotAngle);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    // follow angles are counter clockwise from the leader's facing, in [0, 2 * pi)
+    dist = std::sqrt(forward * forward + left * left);
+    angle = std::atan2(left, forward);
+
+    if (angle < 0.f)
+    {
+        angle += float(2 * M_PI);
+    }
+
+    return true;
+}
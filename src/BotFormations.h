@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_FORMATIONS_H
+#define _BOT_FORMATIONS_H
+
+#include "Define.h"
+#include "MoveSplineInitArgs.h"
+#include "ObjectGuid.h"
+#include "Position.h"
+
+#include <unordered_map>
+#include <vector>
+
+class Creature;
+class Map;
+class Unit;
+
+enum BotFormationMove
+{
+    BOT_FORMATION_MOVE_NONE             = 0,    // in its slot, or already moving there
+    BOT_FORMATION_MOVE_PATH             = 1,    // move along the returned points
+    BOT_FORMATION_MOVE_FALLBACK         = 2     // slot or path unusable, the follow generator finds a path of its own
+};
+
+// Leader => formation slots of the bots following it (NpcBots.Formation.Type).
+// A slot is a follow offset (distance and angle from the leader's facing).
+// The path of the leader is computed once each time it moves and is shared by
+// its followers: a follower joins the path at its nearest point and leaves it
+// for its slot. Only a follower whose slot is unreachable or which is away from
+// the path falls back to its follow generator, which paths on its own.
+//
+// Owned by BotMapData, only used from the thread updating the map.
+class BotFormations
+{
+public:
+    explicit BotFormations(Map* map);
+
+public:
+    void Update(uint32 diff);
+
+    // follow offset of the bot's slot, false without a formation (dist and angle untouched)
+    bool GetSlotOffset(Unit const* leader, Creature const* bot, float& dist, float& angle);
+
+    // where the bot should go to keep its slot, points are filled for BOT_FORMATION_MOVE_PATH
+    BotFormationMove GetSlotMove(Unit const* leader, Creature const* bot, Movement::PointsArray& points);
+
+private:
+    struct Slot
+    {
+        ObjectGuid botGUID;
+        uint32 seenTime;
+        Position target;
+    };
+
+    struct Formation
+    {
+        std::vector<Slot> slots;
+
+        // leader path, from its previous to its current position
+        Movement::PointsArray path;
+    };
+
+    // assigns a slot on the first call
+    Slot& GetSlot(Formation& formation, Creature const* bot, uint32& index);
+    void UpdateLeaderPath(Formation& formation, Unit const* leader);
+    bool GetSlotPosition(Unit const* leader, float dist, float angle, Position& pos) const;
+
+    static bool GetSlotOffset(uint32 slot, uint32 count, float& dist, float& angle);
+
+private:
+    Map* m_map;
+    uint32 m_time;
+    std::unordered_map<ObjectGuid, Formation> m_formations;
+};
+
+#endif // _BOT_FORMATIONS_H
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotGroupProximity.h"
+#include "GridDefines.h"
+#include "Group.h"
+#include "Map.h"
+#include "Player.h"
+
+#include <algorithm>
+
+BotGroupProximity::BotGroupProximity(Map* map) : m_map(map), m_tick(1)
+{
+}
+
+void BotGroupProximity::Update()
+{
+    // forget groups nobody asked about during the last update
+    for (auto itr = m_groups.begin(); itr != m_groups.end();)
+    {
+        if (itr->second.tick != m_tick)
+        {
+            itr = m_groups.erase(itr);
+        }
+        else
+        {
+            ++itr;
+        }
+    }
+
+    ++m_tick;
+}
+
+bool BotGroupProximity::IsWithinDistOfAnyMember(Group const* group, WorldObject const* obj, float dist)
+{
+    Summary& summary = m_groups[group->GetGUID().GetCounter()];
+
+    if (summary.tick != m_tick)
+    {
+        Build(group, summary);
+    }
+
+    if (summary.members.empty())
+    {
+        return false;
+    }
+
+    float const x = obj->GetPositionX();
+    float const y = obj->GetPositionY();
+    float const reach = dist + obj->GetObjectSize() + summary.maxSize;
+
+    if (x < summary.minX - reach || x > summary.maxX + reach ||
+        y < summary.minY - reach || y > summary.maxY + reach)
+    {
+        return false;
+    }
+
+    // cells the players in reach can be in
+    CellCoord const a = Acore::ComputeCellCoord(x - reach, y - reach);
+    CellCoord const b = Acore::ComputeCellCoord(x + reach, y + reach);
+
+    uint32 const lowX = std::min(a.x_coord, b.x_coord);
+    uint32 const highX = std::max(a.x_coord, b.x_coord);
+    uint32 const lowY = std::min(a.y_coord, b.y_coord);
+    uint32 const highY = std::max(a.y_coord, b.y_coord);
+
+    for (Member const& member : summary.members)
+    {
+        if (member.cellX < lowX || member.cellX > highX ||
+            member.cellY < lowY || member.cellY > highY)
+        {
+            continue;
+        }
+
+        if (!(member.phaseMask & obj->GetPhaseMask()))
+        {
+            continue;
+        }
+
+        // as WorldObject::_IsWithinDist(), 3d with object sizes
+        float const dx = member.x - x;
+        float const dy = member.y - y;
+        float const dz = member.z - obj->GetPositionZ();
+        float const maxdist = dist + obj->GetObjectSize() + member.size;
+
+        if (dx * dx + dy * dy + dz * dz < maxdist * maxdist)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void BotGroupProximity::Build(Group const* group, Summary& summary)
+{
+    summary.tick = m_tick;
+    summary.maxSize = 0.f;
+    summary.members.clear();
+
+    for (GroupReference const* ref = group->GetFirstMember(); ref != nullptr; ref = ref->next())
+    {
+        Player const* player = ref->GetSource();
+
+        if (!player || !player->IsInWorld() || player->FindMap() != m_map)
+        {
+            continue;
+        }
+
+        CellCoord const cell = Acore::ComputeCellCoord(player->GetPositionX(), player->GetPositionY());
+
+        summary.members.push_back({
+            cell.x_coord,
+            cell.y_coord,
+            player->GetPositionX(),
+            player->GetPositionY(),
+            player->GetPositionZ(),
+            player->GetObjectSize(),
+            player->GetPhaseMask() });
+
+        if (summary.members.size() == 1)
+        {
+            summary.minX = summary.maxX = player->GetPositionX();
+            summary.minY = summary.maxY = player->GetPositionY();
+        }
+        else
+        {
+            summary.minX = std::min(summary.minX, player->GetPositionX());
+            summary.maxX = std::max(summary.maxX, player->GetPositionX());
+            summary.minY = std::min(summary.minY, player->GetPositionY());
+            summary.maxY = std::max(summary.maxY, player->GetPositionY());
+        }
+
+        summary.maxSize = std::max(summary.maxSize, player->GetObjectSize());
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_GROUP_PROXIMITY_H
+#define _BOT_GROUP_PROXIMITY_H
+
+#include "Define.h"
+#include "ObjectGuid.h"
+
+#include <unordered_map>
+#include <vector>
+
+class Group;
+class Map;
+class WorldObject;
+
+// Group => positions of its players on the map, for follower range checks.
+// A summary (bounding box, cell and position of every player) is built on the
+// first query of a group in a map update and shared by all bots of the group,
+// so each bot answers "is any player near me" without walking the group.
+//
+// Owned by BotMapData, only used from the thread updating the map.
+class BotGroupProximity
+{
+public:
+    explicit BotGroupProximity(Map* map);
+
+public:
+    // new map update, summaries are rebuilt on their next query
+    void Update();
+
+    // same result as IsWithinDistInMap(member, dist) for any player of the group
+    bool IsWithinDistOfAnyMember(Group const* group, WorldObject const* obj, float dist);
+
+private:
+    struct Member
+    {
+        uint32 cellX;
+        uint32 cellY;
+        float x;
+        float y;
+        float z;
+        float size;
+        uint32 phaseMask;
+    };
+
+    struct Summary
+    {
+        uint32 tick = 0;
+        float minX = 0.f;
+        float maxX = 0.f;
+        float minY = 0.f;
+        float maxY = 0.f;
+        float maxSize = 0.f;
+        std::vector<Member> members;
+    };
+
+    void Build(Group const* group, Summary& summary);
+
+private:
+    Map* m_map;
+    uint32 m_tick;
+    std::unordered_map<ObjectGuid::LowType, Summary> m_groups;
+};
+
+#endif // _BOT_GROUP_PROXIMITY_H
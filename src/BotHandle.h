@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_HANDLE_H
+#define _BOT_HANDLE_H
+
+#include "Define.h"
+
+// Cheap, copyable reference to a BotsRegistry entry (registry slot + slot generation).
+// A handle can be kept across ticks and in delayed events: resolving it through
+// BotsRegistry::Resolve(...) is O(1), takes no lock and yields nothing once the
+// bot it was issued for has been unregistered, even if the slot was reused since.
+class BotHandle
+{
+    friend class BotEntry;
+
+public:
+    BotHandle() : m_slot(0), m_generation(0) { }
+
+public:
+    bool IsEmpty() const { return m_generation == 0; }
+    uint32 GetSlot() const { return m_slot; }
+    uint32 GetGeneration() const { return m_generation; }
+
+    bool operator == (BotHandle const& other) const { return m_slot == other.m_slot && m_generation == other.m_generation; }
+    bool operator != (BotHandle const& other) const { return !(*this == other); }
+
+private:
+    BotHandle(uint32 slot, uint32 generation) : m_slot(slot), m_generation(generation) { }
+
+private:
+    uint32 m_slot;
+    uint32 m_generation;
+};
+
+#endif // _BOT_HANDLE_H
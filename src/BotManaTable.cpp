@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotManaTable.h"
+#include "BotAI.h"
+#include "DBCStores.h"
+#include "Log.h"
+#include "StringFormat.h"
+
+BotManaTable::BotManaTable()
+{
+    for (uint32 botClass = 0; botClass != BOT_CLASS_END; ++botClass)
+    {
+        for (uint32 level = 0; level <= GT_MAX_LEVEL; ++level)
+        {
+            m_curves[botClass][level] = BotManaCurve();
+        }
+    }
+}
+
+void BotManaTable::Build()
+{
+    for (uint32 botClass = 0; botClass != BOT_CLASS_END; ++botClass)
+    {
+        for (uint32 level = 1; level <= GT_MAX_LEVEL; ++level)
+        {
+            m_curves[botClass][level] = BuildCurve(botClass, uint8(level));
+        }
+
+        m_curves[botClass][0] = m_curves[botClass][1];
+    }
+
+    LOG_INFO(
+        "npcbots",
+        "bot mana table built: {} classes, {} levels",
+        uint32(BOT_CLASS_END),
+        uint32(GT_MAX_LEVEL));
+}
+
+BotManaCurve const& BotManaTable::GetCurve(uint32 botClass, uint8 level) const
+{
+    if (botClass >= BOT_CLASS_END)
+    {
+        botClass = BOT_CLASS_NONE;
+    }
+
+    if (level > GT_MAX_LEVEL)
+    {
+        level = GT_MAX_LEVEL;
+    }
+
+    return m_curves[botClass][level];
+}
+
+BotManaCurve BotManaTable::BuildCurve(uint32 botClass, uint8 level)
+{
+    BotManaCurve curve = BotManaCurve();
+    int32 const lvl = level;
+
+    // max mana
+    curve.hasFixedBaseMana = true;
+
+    switch (botClass)
+    {
+        case BOT_CLASS_BM:
+            curve.baseMana = (float)BASE_MANA_1_BM + (BASE_MANA_10_BM - BASE_MANA_1_BM) * (lvl / 81.f);
+            break;
+        case BOT_CLASS_SPHYNX:
+            curve.baseMana = BASE_MANA_SPHYNX;
+            break;
+        case BOT_CLASS_ARCHMAGE:
+            curve.baseMana = (float)BASE_MANA_1_ARCHMAGE + (BASE_MANA_10_ARCHMAGE - BASE_MANA_1_ARCHMAGE) * ((lvl - 20) / 81.f);
+            break;
+        case BOT_CLASS_DREADLORD:
+            curve.baseMana = (float)BASE_MANA_1_DREADLORD + (BASE_MANA_10_DREADLORD - BASE_MANA_1_DREADLORD) * ((lvl - 60) / 83.f);
+            break;
+        case BOT_CLASS_SPELLBREAKER:
+            curve.baseMana = BASE_MANA_SPELLBREAKER;
+            break;
+        case BOT_CLASS_DARK_RANGER:
+            curve.baseMana = (float)BASE_MANA_1_DARK_RANGER + (BASE_MANA_10_DARK_RANGER - BASE_MANA_1_DARK_RANGER) * ((lvl - 40) / 82.f);
+            break;
+        case BOT_CLASS_NECROMANCER:
+            curve.baseMana = BASE_MANA_NECROMANCER;
+            break;
+        default:
+            curve.hasFixedBaseMana = false;
+            break;
+    }
+
+    curve.intellectMult = botClass < BOT_CLASS_EX_START ? 15.f : BotAI::IsHeroExClass(botClass) ? 5.f : 1.5f;
+
+    //Fel Vitality
+    if (botClass == BOT_CLASS_WARLOCK && lvl >= 15)
+    {
+        curve.manaBonusPct = 3;
+    }
+
+    // mana regen
+    if (botClass != BOT_CLASS_NONE && botClass < BOT_CLASS_EX_START)
+    {
+        if (GtRegenMPPerSptEntry const* moreRatio = sGtRegenMPPerSptStore.LookupEntry((botClass - 1) * GT_MAX_LEVEL + lvl - 1))
+        {
+            curve.hasSpiritRegenRatio = true;
+            curve.spiritRegenRatio = moreRatio->ratio;
+        }
+    }
+    else if (BotAI::IsHeroExClass(botClass))
+    {
+        float basemana = 0.f;
+
+        switch (botClass)
+        {
+            case BOT_CLASS_BM:          basemana = BASE_MANA_1_BM;          break;
+            case BOT_CLASS_ARCHMAGE:    basemana = BASE_MANA_1_ARCHMAGE;    break;
+            case BOT_CLASS_DREADLORD:   basemana = BASE_MANA_1_DREADLORD;   break;
+            case BOT_CLASS_DARK_RANGER: basemana = BASE_MANA_1_DARK_RANGER; break;
+            default:                                                        break;
+        }
+
+        curve.hasBaseRegen = true;
+        curve.baseRegen = basemana * 0.0087f;
+        curve.intellectRegenMult = 0.08f;
+    }
+    else if (botClass == BOT_CLASS_SPELLBREAKER)
+    {
+        curve.hasBaseRegen = true;
+        curve.baseRegen = 4.f; //base 0.8/sec
+    }
+    else if (botClass == BOT_CLASS_NECROMANCER)
+    {
+        curve.hasBaseRegen = true;
+        curve.baseRegen = 7.5f; //base 1.5/sec
+    }
+
+    return curve;
+}
+
+void BotManaTable::BuildDump(std::vector<std::string>& lines, uint32 botClass) const
+{
+    lines.push_back("class / level: base mana / int mult / bonus pct / spirit ratio / base regen / int regen mult");
+
+    for (uint32 c = BOT_CLASS_WARRIOR; c != BOT_CLASS_END; ++c)
+    {
+        if (botClass != BOT_CLASS_NONE && c != botClass)
+        {
+            continue;
+        }
+
+        for (uint32 level = 1; level <= GT_MAX_LEVEL; ++level)
+        {
+            BotManaCurve const& curve = m_curves[c][level];
+
+            lines.push_back(Acore::StringFormatFmt(
+                "{} / {}: {} / {:.1f} / {} / {} / {} / {:.2f}",
+                c,
+                level,
+                curve.hasFixedBaseMana ? Acore::StringFormatFmt("{:.1f}", curve.baseMana) : "creature",
+                curve.intellectMult,
+                curve.manaBonusPct,
+                curve.hasSpiritRegenRatio ? Acore::StringFormatFmt("{:.6f}", curve.spiritRegenRatio) : "-",
+                curve.hasBaseRegen ? Acore::StringFormatFmt("{:.2f}", curve.baseRegen) : "-",
+                curve.intellectRegenMult));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_MANA_TABLE_H
+#define _BOT_MANA_TABLE_H
+
+#include "BotCommon.h"
+#include "DBCEnums.h"
+
+#include <string>
+#include <vector>
+
+// level dependent part of the bot mana and mana regen formulas,
+// see BotAI::OnManaUpdate() and BotAI::OnManaRegenUpdate()
+struct BotManaCurve
+{
+    bool hasFixedBaseMana;      // ex classes, other classes use the creature base stats
+    float baseMana;
+    float intellectMult;        // max mana per point of intellect
+    uint8 manaBonusPct;         // max mana talents (Fel Vitality)
+
+    bool hasSpiritRegenRatio;   // regen per spirit from gtRegenMPPerSpt, regular classes only
+    float spiritRegenRatio;
+
+    bool hasBaseRegen;          // ex classes, mp5 before the intellect and aura terms
+    float baseRegen;
+    float intellectRegenMult;   // mp5 per point of intellect, hero ex classes
+};
+
+// (class, level) table of BotManaCurve, built once at startup
+class BotManaTable
+{
+protected:
+    explicit BotManaTable();
+
+public:
+    static BotManaTable* instance()
+    {
+        static BotManaTable instance;
+        return &instance;
+    }
+
+public:
+    void Build();
+
+    // level is clamped to [1, GT_MAX_LEVEL]
+    BotManaCurve const& GetCurve(uint32 botClass, uint8 level) const;
+
+    // one line per (class, level), all classes if botClass is BOT_CLASS_NONE
+    void BuildDump(std::vector<std::string>& lines, uint32 botClass = BOT_CLASS_NONE) const;
+
+private:
+    static BotManaCurve BuildCurve(uint32 botClass, uint8 level);
+
+private:
+    BotManaCurve m_curves[BOT_CLASS_END][GT_MAX_LEVEL + 1];
+};
+
+#define sBotManaTable BotManaTable::instance()
+
+#endif // _BOT_MANA_TABLE_H
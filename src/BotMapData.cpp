@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotMapData.h"
+#include "BotEpoch.h"
+#include "Map.h"
+
+void BotMapData::Update(uint32 diff)
+{
+    m_scheduler.Update(diff);
+    m_regenBatch.Update(diff);
+    m_groupProximity.Update();
+    m_formations.Update(diff);
+    m_pathCache.Update(diff);
+}
+
+BotMapDataMgr::~BotMapDataMgr()
+{
+    delete m_table.load();
+}
+
+BotMapData* BotMapDataMgr::GetOrCreate(Map* map)
+{
+    if (BotMapData* result = Find(map))
+    {
+        return result;
+    }
+
+    lock();
+
+    std::unique_ptr<BotMapData>& data = m_mapData[map];
+
+    if (!data)
+    {
+        data = std::make_unique<BotMapData>(map);
+        Publish();
+    }
+
+    BotMapData* result = data.get();
+
+    unlock();
+
+    return result;
+}
+
+BotMapData* BotMapDataMgr::Find(Map* map) const
+{
+    BotEpochGuard guard;
+    BotMapDataTable const* table = m_table.load(std::memory_order_seq_cst);
+
+    auto itr = table->find(map);
+
+    return itr != table->end() ? itr->second : nullptr;
+}
+
+void BotMapDataMgr::Remove(Map* map)
+{
+    std::unique_ptr<BotMapData> data;
+
+    lock();
+
+    auto itr = m_mapData.find(map);
+
+    if (itr != m_mapData.end())
+    {
+        data = std::move(itr->second);
+        m_mapData.erase(itr);
+        Publish();
+    }
+
+    unlock();
+}
+
+void BotMapDataMgr::Publish()
+{
+    BotMapDataTable* table = new BotMapDataTable();
+    table->reserve(m_mapData.size());
+
+    for (auto& pair : m_mapData)
+    {
+        table->emplace(pair.first, pair.second.get());
+    }
+
+    BotMapDataTable const* old = m_table.exchange(table, std::memory_order_seq_cst);
+
+    sBotEpoch->Retire([old]()
+    {
+        delete old;
+    });
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_MAP_DATA_H
+#define _BOT_MAP_DATA_H
+
+#include "BotFormations.h"
+#include "BotGroupProximity.h"
+#include "BotPathCache.h"
+#include "BotProfiler.h"
+#include "BotRegenBatch.h"
+#include "BotScheduler.h"
+#include "BotTraffic.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class Map;
+class BotMapData;
+
+typedef std::unordered_map<Map*, BotMapData*> BotMapDataTable;
+
+// Bot state shared by all bots of one map.
+// Only touched from the thread updating the map.
+class BotMapData
+{
+public:
+    explicit BotMapData(Map* map) : m_map(map), m_scheduler(map), m_regenBatch(map, m_traffic), m_groupProximity(map), m_formations(map), m_pathCache(map) { }
+
+public:
+    void Update(uint32 diff);
+
+    Map* GetMap() const { return m_map; }
+    BotScheduler& GetScheduler() { return m_scheduler; }
+    BotProfiler& GetProfiler() { return m_profiler; }
+    BotRegenBatch& GetRegenBatch() { return m_regenBatch; }
+    BotGroupProximity& GetGroupProximity() { return m_groupProximity; }
+    BotFormations& GetFormations() { return m_formations; }
+    BotPathCache& GetPathCache() { return m_pathCache; }
+    BotTrafficBuffer& GetTraffic() { return m_traffic; }
+
+private:
+    Map* m_map;
+    // before m_regenBatch, which records into it
+    BotTrafficBuffer m_traffic;
+    BotScheduler m_scheduler;
+    BotProfiler m_profiler;
+    BotRegenBatch m_regenBatch;
+    BotGroupProximity m_groupProximity;
+    BotFormations m_formations;
+    BotPathCache m_pathCache;
+};
+
+// Map => BotMapData. Entries are created by the first bot updated on a map and
+// removed when the map is destroyed. Maps update in parallel: creating and
+// removing lock and publish a new lookup table, Find() only pins the epoch and
+// reads the published table (see BotEpoch).
+class BotMapDataMgr
+{
+protected:
+    explicit BotMapDataMgr() : m_table(new BotMapDataTable()) { }
+    ~BotMapDataMgr();
+
+public:
+    static BotMapDataMgr* instance()
+    {
+        static BotMapDataMgr instance;
+        return &instance;
+    }
+
+public:
+    BotMapData* GetOrCreate(Map* map);
+    // no lock, called by every map update
+    BotMapData* Find(Map* map) const;
+    void Remove(Map* map);
+
+    // calls fn(BotMapData&) for every map holding bot data, under the lock
+    template<typename Fn>
+    void ForEach(Fn&& fn)
+    {
+        lock();
+
+        for (auto& pair : m_mapData)
+        {
+            fn(*pair.second);
+        }
+
+        unlock();
+    }
+
+private:
+    // caller must hold the lock
+    void Publish();
+
+    void lock()
+    {
+        m_lock.lock();
+    }
+
+    void unlock()
+    {
+        m_lock.unlock();
+    }
+
+private:
+    std::mutex m_lock;
+    std::unordered_map<Map*, std::unique_ptr<BotMapData>> m_mapData;
+
+    // read side copy of m_mapData, replaced by Publish()
+    std::atomic<BotMapDataTable const*> m_table;
+};
+
+#define sBotMapDataMgr BotMapDataMgr::instance()
+
+#endif // _BOT_MAP_DATA_H
@@ -7,46 +7,211 @@
 #include "Creature.h"
 #include "BotAI.h"
 #include "BotCommon.h"
+#include "BotConfig.h"
 #include "BotEvents.h"
 #include "BotMgr.h"
+#include "BotPartyStats.h"
+#include "BotTraffic.h"
+#include "DBCStores.h"
 #include "Group.h"
 #include "Item.h"
 #include "Log.h"
 #include "Map.h"
 #include "MapMgr.h"
+#include "ObjectAccessor.h"
 #include "Player.h"
+#include "StringFormat.h"
 #include "Unit.h"
+#include "World.h"
 
-void BotsRegistry::Register(BotAI* ai)
+#include <fstream>
+#include <map>
+#include <thread>
+
+uint32 BotsRegistrySnapshot::HashGuid(ObjectGuid guid)
 {
-    ASSERT(ai != nullptr);
-    ASSERT(ai->GetBot() != nullptr);
+    // fibonacci hashing, the high bits are the well mixed ones
+    return uint32((guid.GetRawValue() * 0x9E3779B97F4A7C15ULL) >> 32);
+}
 
-    Creature* bot = ai->GetBot();
-    ObjectGuid botGUID = bot->GetGUID();
+int32 BotsRegistrySnapshot::FindIndex(ObjectGuid botGUID) const
+{
+    if (m_buckets.empty())
+    {
+        return -1;
+    }
 
-    lock();
+    for (uint32 bucket = HashGuid(botGUID) & m_bucketMask; ; bucket = (bucket + 1) & m_bucketMask)
+    {
+        uint32 stored = m_buckets[bucket];
+
+        if (!stored)
+        {
+            return -1;
+        }
+
+        if (m_entries[stored - 1].m_botGUID == botGUID)
+        {
+            return int32(stored - 1);
+        }
+    }
+}
 
-    BotEntryMap::iterator itr = m_botRegistry.find(botGUID);
+BotEntry const* BotsRegistrySnapshot::Find(ObjectGuid botGUID) const
+{
+    int32 index = FindIndex(botGUID);
 
-    if (itr != m_botRegistry.end())
+    return index >= 0 ? &m_entries[index] : nullptr;
+}
+
+BotEntry const* BotsRegistrySnapshot::FindBySlot(uint32 slot, uint32 generation) const
+{
+    if (slot >= m_slots.size() || m_slots[slot].generation != generation)
     {
-        m_botRegistry.erase(itr);
-        delete itr->second;
+        return nullptr;
     }
 
-    LOG_WARN(
+    return &m_entries[m_slots[slot].index];
+}
+
+std::vector<BotEntry const*> const* BotsRegistrySnapshot::FindByOwner(ObjectGuid ownerGUID) const
+{
+    BotOwnerIndexMap::const_iterator itr = m_ownerIndex.find(ownerGUID);
+
+    return itr != m_ownerIndex.end() ? &itr->second : nullptr;
+}
+
+// indexes are stale until BuildIndexes() is called
+void BotsRegistrySnapshot::Insert(BotEntry entry)
+{
+    uint32 slot;
+
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = m_slots.size();
+        m_slots.emplace_back();
+    }
+
+    entry.m_slot = slot;
+    entry.m_generation = m_slots[slot].generation;
+
+    m_slots[slot].index = m_entries.size();
+    m_entries.push_back(entry);
+}
+
+// indexes are stale until BuildIndexes() is called
+void BotsRegistrySnapshot::Erase(uint32 index)
+{
+    ASSERT(index < m_entries.size());
+
+    uint32 slot = m_entries[index].m_slot;
+
+    ++m_slots[slot].generation;
+    m_freeSlots.push_back(slot);
+
+    // keep the array dense: move the last entry into the hole
+    if (index != m_entries.size() - 1)
+    {
+        m_entries[index] = m_entries.back();
+        m_slots[m_entries[index].m_slot].index = index;
+    }
+
+    m_entries.pop_back();
+}
+
+void BotsRegistrySnapshot::BuildIndexes()
+{
+    uint32 capacity = 16;
+
+    while (capacity < m_entries.size() * 2)
+    {
+        capacity <<= 1;
+    }
+
+    m_buckets.assign(capacity, 0);
+    m_bucketMask = capacity - 1;
+    m_ownerIndex.clear();
+
+    for (uint32 index = 0; index < m_entries.size(); ++index)
+    {
+        BotEntry const& entry = m_entries[index];
+
+        uint32 bucket = HashGuid(entry.m_botGUID) & m_bucketMask;
+
+        while (m_buckets[bucket])
+        {
+            bucket = (bucket + 1) & m_bucketMask;
+        }
+
+        m_buckets[bucket] = index + 1;
+
+        if (!entry.m_ownerGUID.IsEmpty())
+        {
+            m_ownerIndex[entry.m_ownerGUID].push_back(&entry);
+        }
+    }
+}
+
+BotsRegistry::~BotsRegistry()
+{
+    delete m_snapshot.load();
+}
+
+BotHandle BotsRegistry::Register(BotAI* ai)
+{
+    ASSERT(ai != nullptr);
+    ASSERT(ai->GetBot() != nullptr);
+
+    Creature* bot = ai->GetBot();
+
+    Unit* owner = ai->GetBotOwner();
+    ObjectGuid ownerGUID = owner ? owner->GetGUID() : ObjectGuid::Empty;
+
+    LOG_DEBUG(
         "npcbots",
         "register bot [GUID: {} AI: 0X{:016x}  {}] to bot registry...",
         bot->GetGUID().GetCounter(),
         (unsigned long long)ai,
         bot->GetName().c_str());
 
-    m_botRegistry[botGUID] = new BotEntry(ai);
+    BotHandle handle = RegisterEntry(ai, bot->GetGUID(), ownerGUID, bot->GetEntry());
+
+    ai->SetBotHandle(handle);
+
+    return handle;
+}
+
+BotHandle BotsRegistry::RegisterEntry(BotAI* ai, ObjectGuid botGUID, ObjectGuid ownerGUID, uint32 creatureEntry)
+{
+    lock();
+
+    // an entry for the same guid (old AI of a teleported bot) is replaced.
+    // the replacement gets a fresh slot generation.
+    int32 index = FindMasterIndex(botGUID);
+
+    if (index >= 0)
+    {
+        m_masterSlots.erase(botGUID);
+        m_master.Erase(index);
+    }
+
+    m_master.Insert(BotEntry(ai, botGUID, ownerGUID, creatureEntry));
+
+    BotHandle handle = m_master.GetEntries().back().GetHandle();
+    m_masterSlots[botGUID] = handle.GetSlot();
+
+    Publish();
 
     unlock();
 
-    sBotsRegistry->LogBotRegistryEntries();
+    ++m_registerCount;
+
+    return handle;
 }
 
 void BotsRegistry::Unregister(BotAI* ai)
@@ -55,157 +220,321 @@ void BotsRegistry::Unregister(BotAI* ai)
     ASSERT(ai->GetBot() != nullptr);
 
     Creature* bot = ai->GetBot();
-    ObjectGuid botGUID = bot->GetGUID();
 
+    if (UnregisterEntry(ai, bot->GetGUID()))
+    {
+        LOG_DEBUG(
+            "npcbots",
+            "bot [GUID: {} AI: 0X{:016x}  {}] unregister from bot registry.",
+            bot->GetGUID().GetCounter(),
+            (unsigned long long)ai,
+            bot->GetName().c_str());
+    }
+    else
+    {
+        LOG_DEBUG(
+            "npcbots",
+            "bot [GUID: {} AI: 0X{:016x}  {}] skip unregister from bot registry.",
+            bot->GetGUID().GetCounter(),
+            (unsigned long long)ai,
+            bot->GetName().c_str());
+    }
+}
+
+// false if the entry of botGUID belongs to another AI (teleported bot) or is gone
+bool BotsRegistry::UnregisterEntry(BotAI* ai, ObjectGuid botGUID)
+{
     lock();
 
-    BotEntryMap::iterator itr = m_botRegistry.find(botGUID);
+    int32 index = FindMasterIndex(botGUID);
+    bool erased = index >= 0 && m_master.GetEntries()[index].GetBotAI() == ai;
 
-    if (itr != m_botRegistry.end())
+    if (erased)
     {
-        BotEntry* entry = itr->second;
+        m_masterSlots.erase(botGUID);
+        m_master.Erase(index);
 
-        if (entry->GetBot()->GetGUID() == botGUID && entry->GetBotAI() != ai)
-        {
-            LOG_WARN(
-                "npcbots",
-                "bot [GUID: {} AI: 0X{:016x}  {}] skip unregister from bot registry.",
-                bot->GetGUID().GetCounter(),
-                (unsigned long long)ai,
-                bot->GetName().c_str());
-        }
-        else
-        {
-            LOG_WARN(
-                "npcbots",
-                "bot [GUID: {} AI: 0X{:016x}  {}] unregister from bot registry.",
-                bot->GetGUID().GetCounter(),
-                (unsigned long long)ai,
-                bot->GetName().c_str());
-
-            m_botRegistry.erase(botGUID);
-            delete entry;
-        }
+        Publish();
     }
 
     unlock();
 
-    sBotsRegistry->LogBotRegistryEntries();
+    if (erased)
+    {
+        ++m_unregisterCount;
+    }
+
+    return erased;
 }
 
-BotEntry* BotsRegistry::GetEntry(Creature const* bot)
+void BotsRegistry::SetEntryOwner(Creature const* bot, ObjectGuid ownerGUID)
 {
     ASSERT(bot != nullptr);
 
+    SetEntryOwner(bot->GetGUID(), ownerGUID);
+}
+
+void BotsRegistry::SetEntryOwner(ObjectGuid botGUID, ObjectGuid ownerGUID)
+{
     lock();
 
-    BotEntryMap::iterator itr = m_botRegistry.find(bot->GetGUID());
-    BotEntry* entry = nullptr;
+    int32 index = FindMasterIndex(botGUID);
 
-    if (itr != m_botRegistry.end())
+    if (index >= 0 && m_master.m_entries[index].m_ownerGUID != ownerGUID)
     {
-        entry = itr->second;
+        m_master.m_entries[index].m_ownerGUID = ownerGUID;
+
+        Publish();
     }
 
     unlock();
+}
+
+int32 BotsRegistry::FindMasterIndex(ObjectGuid botGUID) const
+{
+    auto itr = m_masterSlots.find(botGUID);
 
-    return entry;
+    return itr != m_masterSlots.end() ? int32(m_master.m_slots[itr->second].index) : -1;
 }
 
-BotEntryMap BotsRegistry::GetEntryByOwnerGUID(ObjectGuid ownerGUID)
+void BotsRegistry::Publish()
 {
-    BotEntryMap botsMap;
+    BotsRegistrySnapshot* next = new BotsRegistrySnapshot(m_master);
+    next->BuildIndexes();
 
-    lock();
+    BotsRegistrySnapshot const* old = m_snapshot.exchange(next, std::memory_order_seq_cst);
 
-    if (!m_botRegistry.empty())
+    // bumped after the swap: a reader which sees the new version also sees the new snapshot
+    m_version.fetch_add(1, std::memory_order_release);
+
+    sBotEpoch->Retire([old]()
     {
-        for (BotEntryMap::iterator itr = m_botRegistry.begin(); itr != m_botRegistry.end(); ++itr)
-        {
-            BotEntry* entry = itr->second;
+        delete old;
+    });
+}
 
-            if (entry)
-            {
-                Unit* owner = entry->GetBotOwner();
+BotsRegistrySnapshotRef BotsRegistry::GetSnapshot() const
+{
+    return BotsRegistrySnapshotRef(m_snapshot);
+}
 
-                if (owner && owner->GetGUID() == ownerGUID)
-                {
-                    botsMap[entry->GetBot()->GetGUID()] = entry;
-                }
-            }
-        }
+Optional<BotEntry> BotsRegistry::GetEntry(Creature const* bot) const
+{
+    ASSERT(bot != nullptr);
+
+    BotsRegistrySnapshotRef snapshot = GetSnapshot();
+
+    if (BotEntry const* entry = snapshot->Find(bot->GetGUID()))
+    {
+        return *entry;
     }
 
-    unlock();
+    return {};
+}
 
-    return botsMap;
+Optional<BotEntry> BotsRegistry::Resolve(BotHandle handle) const
+{
+    if (handle.IsEmpty())
+    {
+        return {};
+    }
+
+    BotsRegistrySnapshotRef snapshot = GetSnapshot();
+
+    if (BotEntry const* entry = snapshot->FindBySlot(handle.GetSlot(), handle.GetGeneration()))
+    {
+        return *entry;
+    }
+
+    return {};
 }
 
-Creature* BotsRegistry::FindFirstBot(uint32 creatureTemplateEntry)
+BotAI* BotsRegistry::ResolveBotAI(BotHandle handle) const
 {
-    lock();
+    if (handle.IsEmpty())
+    {
+        return nullptr;
+    }
+
+    BotsRegistrySnapshotRef snapshot = GetSnapshot();
+    BotEntry const* entry = snapshot->FindBySlot(handle.GetSlot(), handle.GetGeneration());
+
+    return entry ? entry->GetBotAI() : nullptr;
+}
 
-    if (!m_botRegistry.empty())
+bool BotsRegistry::IsCurrent(BotHandle handle) const
+{
+    if (handle.IsEmpty())
     {
-        for (BotEntryMap::iterator itr = m_botRegistry.begin(); itr != m_botRegistry.end(); ++itr)
-        {
-            BotEntry* entry = itr->second;
+        return false;
+    }
 
-            if (entry)
-            {
-                if (entry->GetBot()->GetCreatureTemplate()->Entry == creatureTemplateEntry)
-                {
-                    unlock();
+    BotsRegistrySnapshotRef snapshot = GetSnapshot();
 
-                    return entry->GetBot();
-                }
-            }
+    return snapshot->FindBySlot(handle.GetSlot(), handle.GetGeneration()) != nullptr;
+}
+
+uint32 BotsRegistry::GetBotsCountByOwnerGUID(ObjectGuid ownerGUID) const
+{
+    BotsRegistrySnapshotRef snapshot = GetSnapshot();
+
+    std::vector<BotEntry const*> const* bots = snapshot->FindByOwner(ownerGUID);
+
+    return bots ? bots->size() : 0;
+}
+
+Creature* BotsRegistry::FindFirstBot(uint32 creatureTemplateEntry) const
+{
+    BotsRegistrySnapshotRef snapshot = GetSnapshot();
+
+    for (BotEntry const& entry : snapshot->GetEntries())
+    {
+        if (entry.GetCreatureEntry() == creatureTemplateEntry)
+        {
+            return entry.GetBot();
         }
     }
 
-    unlock();
-
     return nullptr;
 }
 
-void BotsRegistry::LogBotRegistryEntries()
+void BotsRegistry::Update(uint32 diff)
 {
-    lock();
+    m_churnElapsed += diff;
+
+    uint32 interval = sBotConfig->GetRegistrySummaryInterval() * IN_MILLISECONDS;
 
-    if (!m_botRegistry.empty())
+    if (!interval)
     {
-        LOG_WARN("npcbots", "bot registry entries: {} entries", m_botRegistry.size());
+        return;
+    }
+
+    m_summaryTimer += diff;
+
+    if (m_summaryTimer < interval)
+    {
+        return;
+    }
+
+    m_summaryTimer = 0;
+
+    std::vector<std::string> lines;
+    BuildSummary(lines);
+
+    for (std::string const& line : lines)
+    {
+        LOG_INFO("npcbots", "{}", line);
+    }
+}
+
+void BotsRegistry::BuildSummary(std::vector<std::string>& lines)
+{
+    BotsRegistrySnapshotRef snapshot = GetSnapshot();
 
-        for (BotEntryMap::iterator itr = m_botRegistry.begin(); itr != m_botRegistry.end(); ++itr)
+    std::map<uint32 /*mapId*/, uint32> botsPerMap;
+    std::map<ObjectGuid /*owner*/, uint32> botsPerOwner;
+    std::map<uint32 /*botClass*/, uint32> botsPerClass;
+    uint32 freeBots = 0;
+
+    for (BotEntry const& entry : snapshot->GetEntries())
+    {
+        if (Creature const* bot = entry.GetBot())
         {
-            BotEntry* entry = itr->second;
+            ++botsPerMap[bot->GetMapId()];
+        }
 
-            if (entry)
-            {
-                std::string botName = entry->GetBot()? entry->GetBot()->GetName() : "null";
-                std::string botOwnerName = entry->GetBotOwner() ? entry->GetBotOwner()->GetName() : "null";
-
-                LOG_WARN(
-                    "npcbots",
-                    "    +-- GUID Low: {}, Entry: [ name: \"{}\", owner: \"{}\", ai: 0X{:016x} ]",
-                    itr->first.GetCounter(),
-                    botName.c_str(),
-                    botOwnerName.c_str(),
-                    entry->GetBotAI() ? (unsigned long long)entry->GetBotAI() : 0);
-            }
-            else
-            {
-                LOG_ERROR("npcbots","    +-- GUID Low: {}, Entry: null", itr->first.GetCounter());
-            }
+        if (entry.GetBotOwnerGUID().IsEmpty())
+        {
+            ++freeBots;
         }
+        else
+        {
+            ++botsPerOwner[entry.GetBotOwnerGUID()];
+        }
+
+        ++botsPerClass[entry.GetBotAI()->GetRealBotClass()];
     }
-    else
+
+    // churn since the previous summary (periodic or command)
+    uint32 registerCount = m_registerCount;
+    uint32 unregisterCount = m_unregisterCount;
+    uint32 registered = registerCount - m_lastRegisterCount;
+    uint32 unregistered = unregisterCount - m_lastUnregisterCount;
+    float minutes = std::max<uint32>(m_churnElapsed, IN_MILLISECONDS) / float(MINUTE * IN_MILLISECONDS);
+
+    m_lastRegisterCount = registerCount;
+    m_lastUnregisterCount = unregisterCount;
+    m_churnElapsed = 0;
+
+    lines.push_back(Acore::StringFormatFmt(
+        "bot registry: {} bots ({} hired, {} free), churn {:.1f}/min ({} registered, {} unregistered in {:.1f} min)",
+        snapshot->GetSize(),
+        snapshot->GetSize() - freeBots,
+        freeBots,
+        (registered + unregistered) / minutes,
+        registered,
+        unregistered,
+        minutes));
+
+    for (auto const& pair : botsPerMap)
     {
-        LOG_WARN("npcbots", "bot registry entries:");
-        LOG_WARN("npcbots", "    +-- (empty)");
+        MapEntry const* mapEntry = sMapStore.LookupEntry(pair.first);
+
+        lines.push_back(Acore::StringFormatFmt(
+            "    +-- map {} ({}): {} bots",
+            pair.first,
+            mapEntry ? mapEntry->name[sWorld->GetDefaultDbcLocale()] : "unknown",
+            pair.second));
     }
 
-    unlock();
+    for (auto const& pair : botsPerOwner)
+    {
+        Player const* owner = ObjectAccessor::FindPlayer(pair.first);
+
+        lines.push_back(Acore::StringFormatFmt(
+            "    +-- owner {} ({}): {} bots",
+            pair.first.GetCounter(),
+            owner ? owner->GetName() : "offline",
+            pair.second));
+    }
+
+    for (auto const& pair : botsPerClass)
+    {
+        lines.push_back(Acore::StringFormatFmt("    +-- class {}: {} bots", pair.first, pair.second));
+    }
+}
+
+void BotsRegistry::DumpToFile(std::string const& fileName) const
+{
+    BotsRegistrySnapshotRef snapshot = GetSnapshot();
+
+    // collect on the world thread, bot state must not be read from the writer thread
+    std::vector<std::string> lines;
+    lines.reserve(snapshot->GetSize() + 1);
+
+    lines.push_back(Acore::StringFormatFmt("bot registry entries: {} entries", snapshot->GetSize()));
+
+    for (BotEntry const& entry : snapshot->GetEntries())
+    {
+        Creature const* bot = entry.GetBot();
+        Unit const* owner = entry.GetBotOwner();
+
+        lines.push_back(Acore::StringFormatFmt(
+            "    +-- GUID Low: {}, Entry: [ name: \"{}\", entry: {}, class: {}, map: {}, pos: ({:.2f}, {:.2f}, {:.2f}), owner: \"{}\", slot: {}, ai: 0X{:016x} ]",
+            entry.GetBotGUID().GetCounter(),
+            bot ? bot->GetName() : "null",
+            entry.GetCreatureEntry(),
+            entry.GetBotAI()->GetRealBotClass(),
+            bot ? bot->GetMapId() : 0,
+            bot ? bot->GetPositionX() : 0.f,
+            bot ? bot->GetPositionY() : 0.f,
+            bot ? bot->GetPositionZ() : 0.f,
+            owner ? owner->GetName() : "null",
+            entry.GetHandle().GetSlot(),
+            (unsigned long long)entry.GetBotAI()));
+    }
+
+    BotMgr::WriteFileAsync(fileName, std::move(lines), "bot registry dump");
 }
 
 void BotMgr::HireBot(Player* owner, Creature* bot)
@@ -231,14 +560,27 @@ void BotMgr::HireBot(Player* owner, Creature* bot)
 
         ai->SetBotOwner(owner);
         ai->StartFollow(owner);
+
+        // slot among the owner's bots of the same entry, counted before this one is indexed
+        uint32 slot = 0;
+
+        sBotsRegistry->ForEachBotOfOwner(owner->GetGUID(), [bot, &slot](BotEntry const& entry)
+        {
+            if (entry.GetCreatureEntry() == bot->GetEntry())
+            {
+                ++slot;
+            }
+        });
+
+        ai->SeedRandom(slot);
+
+        sBotsRegistry->SetEntryOwner(bot, owner->GetGUID());
     }
     else
     {
         LOG_ERROR("npcbots", "AI of bot [{}] not found.", bot->GetName().c_str());
     }
 
-    sBotsRegistry->LogBotRegistryEntries();
-
     LOG_DEBUG("npcbots", "[{}] end hire the bot [{}].", owner->GetName().c_str(), bot->GetName().c_str());
 }
 
@@ -254,6 +596,8 @@ bool BotMgr::DismissBot(Creature* bot)
         {
             ai->SetBotOwner(nullptr);
             ai->UnSummonBotPet();
+
+            sBotsRegistry->SetEntryOwner(bot, ObjectGuid::Empty);
             ai->SetFollowComplete();
         }
 
@@ -280,9 +624,7 @@ BotAI* BotMgr::GetBotAI(Creature const* bot)
 
 int BotMgr::GetBotsCount(Unit* owner)
 {
-    BotEntryMap botsMap = sBotsRegistry->GetEntryByOwnerGUID(owner->GetGUID());
-
-    return botsMap.size();
+    return sBotsRegistry->GetBotsCountByOwnerGUID(owner->GetGUID());
 }
 
 void BotMgr::OnBotSpellGo(Unit const* caster, Spell const* spell, bool ok)
@@ -302,25 +644,13 @@ void BotMgr::OnBotOwnerMoveWorldport(Player* player)
         return;
     }
 
-    BotEntryMap botsMap = sBotsRegistry->GetEntryByOwnerGUID(player->GetGUID());
-
-    if (!botsMap.empty())
+    sBotsRegistry->ForEachBotOfOwner(player->GetGUID(), [player](BotEntry const& entry)
     {
-        for (BotEntryMap::iterator itr = botsMap.begin(); itr != botsMap.end(); ++itr)
+        if (BotAI* ai = entry.GetBotAI())
         {
-            BotEntry* entry = itr->second;
-
-            if (entry)
-            {
-                BotAI* ai = entry->GetBotAI();
-
-                if (ai)
-                {
-                    ai->OnBotOwnerMoveWorldport(player);
-                }
-            }
+            ai->OnBotOwnerMoveWorldport(player);
         }
-    }
+    });
 }
 
 void BotMgr::OnBotOwnerMoveTeleport(Player* player)
@@ -330,45 +660,33 @@ void BotMgr::OnBotOwnerMoveTeleport(Player* player)
         return;
     }
 
-    BotEntryMap botsMap = sBotsRegistry->GetEntryByOwnerGUID(player->GetGUID());
-
-    if (!botsMap.empty())
+    sBotsRegistry->ForEachBotOfOwner(player->GetGUID(), [player](BotEntry const& entry)
     {
-        for (BotEntryMap::iterator itr = botsMap.begin(); itr != botsMap.end(); ++itr)
-        {
-            BotEntry* entry = itr->second;
-
-            if (!entry)
-            {
-                continue;
-            }
-
-            Creature* bot = entry->GetBot();
+        Creature* bot = entry.GetBot();
 
-            if (!bot)
-            {
-                continue;
-            }
+        if (!bot)
+        {
+            return;
+        }
 
-            if (bot->IsWithinDist3d(player, 20.0f))
-            {
-                // skip teleport which too close to player.
-                continue;
-            }
+        if (bot->IsWithinDist3d(player, 20.0f))
+        {
+            // skip teleport which too close to player.
+            return;
+        }
 
-            BotMgr::DismissBot(bot);
+        BotMgr::DismissBot(bot);
 
-            bot = player->SummonCreature(
-                                BOT_DREADLORD,
-                                *player,
-                                TEMPSUMMON_MANUAL_DESPAWN);
+        bot = player->SummonCreature(
+                            BOT_DREADLORD,
+                            *player,
+                            TEMPSUMMON_MANUAL_DESPAWN);
 
-            if (bot)
-            {
-                BotMgr::HireBot(player, bot);
-            }
+        if (bot)
+        {
+            BotMgr::HireBot(player, bot);
         }
-    }
+    });
 }
 
 bool BotMgr::TeleportBot(Creature* bot, Map* newMap, float x, float y, float z, float ori)
@@ -416,6 +734,7 @@ bool BotMgr::TeleportBot(Creature* bot, Map* newMap, float x, float y, float z,
             {
                 if (gr->IsMember(bot->GetGUID()))
                 {
+                    sBotTrafficMgr->RecordGroupUpdate(gr, bot->GetGUID(), owner->GetGUID());
                     gr->SendUpdate();
                 }
             }
@@ -430,6 +749,7 @@ bool BotMgr::TeleportBot(Creature* bot, Map* newMap, float x, float y, float z,
     // so wo need save some old AI's state before call AddToMap function.
     Unit* leader = oldAI->GetLeaderForFollower();
     bool isFreeBot = oldAI->IAmFree();
+    BotRandom random = oldAI->GetRandom();
 
     // add bot to new map
     newMap->AddToMap(bot);
@@ -456,12 +776,46 @@ bool BotMgr::TeleportBot(Creature* bot, Map* newMap, float x, float y, float z,
         newAI->SetLeaderGUID(leader->GetGUID());
     }
 
-    TeleportFinishEvent* finishEvent = new TeleportFinishEvent(newAI);
+    // keep the random sequence going, the new AI would restart it
+    newAI->SetRandom(random);
+
+    TeleportFinishEvent* finishEvent = new TeleportFinishEvent(newAI->GetBotHandle());
     newAI->GetEvents()->AddEvent(finishEvent, newAI->GetEvents()->CalculateTime(urand(500, 800)));
 
     return true;
 }
 
+void BotMgr::Update(uint32 diff)
+{
+    sBotsRegistry->Update(diff);
+    sBotPartyStatsMgr->Flush(diff);
+    sBotTrafficMgr->Update(diff);
+
+    // maps are idle, no reader is pinned
+    sBotEpoch->Reclaim();
+}
+
+void BotMgr::WriteFileAsync(std::string const& fileName, std::vector<std::string> lines, std::string const& what)
+{
+    std::thread([fileName, what, lines = std::move(lines)]()
+    {
+        std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+
+        if (!file)
+        {
+            LOG_ERROR("npcbots", "{}: can not open file \"{}\".", what, fileName);
+            return;
+        }
+
+        for (std::string const& line : lines)
+        {
+            file << line << '\n';
+        }
+
+        LOG_INFO("npcbots", "{}: {} lines written to \"{}\".", what, lines.size(), fileName);
+    }).detach();
+}
+
 bool BotMgr::RestrictBots(Creature const* bot, bool /*add*/)
 {
     if (Unit* owner = GetBotAI(bot)->GetBotOwner())
@@ -8,28 +8,43 @@
 #define _BOT_MGR_H
 
 #include "BotCommon.h"
+#include "BotEpoch.h"
+#include "BotHandle.h"
 
+#include "Optional.h"
+
+#include <atomic>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 
 class BotEntry;
 class BotMgr;
 class BotsRegistry;
+class BotsRegistrySnapshot;
 class BotAI;
 class Creature;
 class Map;
 class Player;
 class Unit;
 
-typedef std::map<ObjectGuid, BotEntry*> BotEntryMap;
+typedef std::vector<BotEntry> BotEntryVector;
+typedef std::unordered_map<ObjectGuid, std::vector<BotEntry const*>> BotOwnerIndexMap;
 
 class BotEntry
 {
     friend class BotsRegistry;
+    friend class BotsRegistrySnapshot;
 
 private:
-    explicit BotEntry(BotAI* ai)
+    explicit BotEntry(BotAI* ai, ObjectGuid botGUID, ObjectGuid ownerGUID, uint32 creatureEntry)
     {
         m_botAI = ai;
+        m_botGUID = botGUID;
+        m_ownerGUID = ownerGUID;
+        m_creatureEntry = creatureEntry;
+        m_slot = 0;
+        m_generation = 0;
     }
 
 public:
@@ -37,7 +52,7 @@ public:
 
     bool operator < (const BotEntry& other) const
     {
-        return m_botAI->GetBot()->GetGUID() < other.m_botAI->GetBot()->GetGUID();
+        return m_botGUID < other.m_botGUID;
     }
 
 public:
@@ -46,20 +61,127 @@ public:
     Creature* GetBot() const { return m_botAI->GetBot(); }
     Creature* GetPet() const { return m_botAI->GetPet(); }
 
+    ObjectGuid GetBotGUID() const { return m_botGUID; }
+    ObjectGuid GetBotOwnerGUID() const { return m_ownerGUID; }
+    uint32 GetCreatureEntry() const { return m_creatureEntry; }
+    BotHandle GetHandle() const { return BotHandle(m_slot, m_generation); }
+
     bool IsFreeBot() const { return m_botAI->IAmFree(); }
 
 private:
     BotAI* m_botAI;
+    ObjectGuid m_botGUID;
+
+    // owner guid the entry is indexed under in BotsRegistrySnapshot::m_ownerIndex
+    ObjectGuid m_ownerGUID;
+
+    // creature template entry, cached so lookups by entry never touch the creature
+    uint32 m_creatureEntry;
+
+    // registry slot holding this entry and the slot generation it was stored with
+    uint32 m_slot;
+    uint32 m_generation;
+};
+
+// Immutable version of the registry contents.
+// Readers pin it through a BotsRegistrySnapshotRef, a replaced version is
+// retired to BotEpoch and freed once no pinned reader can still see it.
+//
+// Entries are kept by value in a dense array (no holes, iteration order is not
+// stable). A slot table maps stable slot ids to dense indexes; a slot's
+// generation is bumped whenever it is released, so (slot, generation) pairs
+// taken from an entry go stale once the bot is unregistered. Guid lookups go
+// through an open addressing table (linear probing, load factor <= 0.5) that
+// is rebuilt whenever a new version is published.
+class BotsRegistrySnapshot
+{
+    friend class BotsRegistry;
+
+public:
+    BotsRegistrySnapshot() : m_bucketMask(0) { }
+
+public:
+    BotEntry const* Find(ObjectGuid botGUID) const;
+    BotEntry const* FindBySlot(uint32 slot, uint32 generation) const;
+    std::vector<BotEntry const*> const* FindByOwner(ObjectGuid ownerGUID) const;
+
+    BotEntryVector const& GetEntries() const { return m_entries; }
+    bool IsEmpty() const { return m_entries.empty(); }
+    uint32 GetSize() const { return m_entries.size(); }
+
+private:
+    struct Slot
+    {
+        Slot() : index(0), generation(1) { }
+
+        uint32 index;       // index into m_entries while the slot is in use
+        uint32 generation;  // bumped each time the slot is released
+    };
+
+    int32 FindIndex(ObjectGuid botGUID) const;
+    void Insert(BotEntry entry);
+    void Erase(uint32 index);
+    void BuildIndexes();
+
+    static uint32 HashGuid(ObjectGuid guid);
+
+private:
+    BotEntryVector m_entries;
+    std::vector<Slot> m_slots;
+    std::vector<uint32> m_freeSlots;
+
+    // open addressing guid => (index into m_entries + 1), 0 marks an empty bucket
+    std::vector<uint32> m_buckets;
+    uint32 m_bucketMask;
+
+    // owner guid => bots hired by that owner. free bots are not indexed.
+    // pointers refer into m_entries of the same snapshot.
+    BotOwnerIndexMap m_ownerIndex;
 };
 
+// Pinned view of the published registry snapshot, see BotEpoch.
+// Stack only: keep it for as long as entries of the snapshot are used.
+class BotsRegistrySnapshotRef
+{
+public:
+    explicit BotsRegistrySnapshotRef(std::atomic<BotsRegistrySnapshot const*> const& current)
+    {
+        m_snapshot = current.load(std::memory_order_seq_cst);
+    }
+
+    BotsRegistrySnapshotRef(BotsRegistrySnapshotRef const&) = delete;
+    BotsRegistrySnapshotRef& operator=(BotsRegistrySnapshotRef const&) = delete;
+
+public:
+    BotsRegistrySnapshot const* operator->() const { return m_snapshot; }
+    BotsRegistrySnapshot const& operator*() const { return *m_snapshot; }
+
+private:
+    // pins before the snapshot pointer is loaded
+    BotEpochGuard m_guard;
+    BotsRegistrySnapshot const* m_snapshot;
+};
+
+// Read-mostly bot registry.
+// Writes (register, unregister, hire, dismiss) are serialized by m_writeLock and
+// applied in place to a writer side master copy, which the writer then copies
+// into a new immutable snapshot and swaps in before it releases the lock.
+// Reads only pin the epoch and load the snapshot pointer: they never take the
+// write lock, never copy and never do a shared read-modify-write.
 class BotsRegistry
 {
     friend class BotMgr;
+    friend class BotSelfCheck;
+    friend class BotsRegistryTest;
 
 protected:
-    explicit BotsRegistry()
+    explicit BotsRegistry() : m_snapshot(new BotsRegistrySnapshot()), m_version(0),
+        m_registerCount(0), m_unregisterCount(0)
     {
-        m_botRegistry.clear();
+        m_summaryTimer = 0;
+        m_churnElapsed = 0;
+        m_lastRegisterCount = 0;
+        m_lastUnregisterCount = 0;
     }
 
 public:
@@ -70,30 +192,98 @@ public:
     }
 
 public:
-    void Register(BotAI* ai);
+    BotHandle Register(BotAI* ai);
     void Unregister(BotAI* ai);
-    BotEntry* GetEntry(Creature const* bot);
-    BotEntryMap GetEntryByOwnerGUID(ObjectGuid ownerGUID);
-    Creature* FindFirstBot(uint32 creatureTemplateEntry);
+    void SetEntryOwner(Creature const* bot, ObjectGuid ownerGUID);
+
+    ~BotsRegistry();
+
+    BotsRegistrySnapshotRef GetSnapshot() const;
+    Optional<BotEntry> GetEntry(Creature const* bot) const;
+    Optional<BotEntry> Resolve(BotHandle handle) const;
+    BotAI* ResolveBotAI(BotHandle handle) const;
+    bool IsCurrent(BotHandle handle) const;
+    uint32 GetBotsCountByOwnerGUID(ObjectGuid ownerGUID) const;
+    Creature* FindFirstBot(uint32 creatureTemplateEntry) const;
+
+    // Calls fn(BotEntry const&) for every bot hired by ownerGUID, in place and
+    // without allocating. The walk runs over the snapshot current at the time of
+    // the call, so bots hired or dismissed by fn only show up in later snapshots
+    // and never invalidate it; entries unregistered or replaced (teleported bots
+    // get a new AI) by an earlier callback of the same walk are skipped. The
+    // registry is only looked at again once it was written to during the walk.
+    template<typename Fn>
+    void ForEachBotOfOwner(ObjectGuid ownerGUID, Fn&& fn) const
+    {
+        // loaded first: a write published after the snapshot was loaded always forces the re-check
+        uint64 const version = m_version.load(std::memory_order_acquire);
+        BotsRegistrySnapshotRef snapshot = GetSnapshot();
+        std::vector<BotEntry const*> const* bots = snapshot->FindByOwner(ownerGUID);
+
+        if (!bots)
+        {
+            return;
+        }
+
+        for (BotEntry const* entry : *bots)
+        {
+            if (m_version.load(std::memory_order_acquire) != version && !IsCurrent(entry->GetHandle()))
+            {
+                continue;
+            }
+
+            fn(*entry);
+        }
+    }
 
 public:
-    void LogBotRegistryEntries();
+    // registry inspection, world thread only (reads bot positions and names)
+    void Update(uint32 diff);
+    void BuildSummary(std::vector<std::string>& lines);
+    void DumpToFile(std::string const& fileName) const;
 
 private:
+    BotHandle RegisterEntry(BotAI* ai, ObjectGuid botGUID, ObjectGuid ownerGUID, uint32 creatureEntry);
+    bool UnregisterEntry(BotAI* ai, ObjectGuid botGUID);
+    void SetEntryOwner(ObjectGuid botGUID, ObjectGuid ownerGUID);
+
+    // caller must hold the write lock
+    int32 FindMasterIndex(ObjectGuid botGUID) const;
+    void Publish();
+
     void lock()
     {
-        m_lock.lock();
+        m_writeLock.lock();
     }
 
     void unlock()
     {
-        m_lock.unlock();
+        m_writeLock.unlock();
     }
 
 private:
-    std::mutex m_lock;
+    std::mutex m_writeLock;
 
-    BotEntryMap m_botRegistry;
+    // published snapshot, replaced by Publish()
+    std::atomic<BotsRegistrySnapshot const*> m_snapshot;
+
+    // writer side copy with every write applied, indexes are not maintained.
+    // guids are looked up through m_masterSlots instead.
+    BotsRegistrySnapshot m_master;
+    std::unordered_map<ObjectGuid, uint32 /*slot*/> m_masterSlots;
+
+    // bumped by every publish
+    std::atomic<uint64> m_version;
+
+    // churn counters, never reset. the summary reports the delta since the last one.
+    std::atomic<uint32> m_registerCount;
+    std::atomic<uint32> m_unregisterCount;
+
+    // world thread only
+    uint32 m_summaryTimer;
+    uint32 m_churnElapsed;
+    uint32 m_lastRegisterCount;
+    uint32 m_lastUnregisterCount;
 };
 
 #define sBotsRegistry BotsRegistry::instance()
@@ -116,6 +306,12 @@ public:
     static void OnBotOwnerMoveTeleport(Player* player);
     static bool RestrictBots(Creature const* bot, bool add);
     static bool TeleportBot(Creature* bot, Map* newMap, float x, float y, float z, float ori);
+
+    // world update
+    static void Update(uint32 diff);
+
+    // writes lines to fileName on a detached thread, the caller does not wait for the disk
+    static void WriteFileAsync(std::string const& fileName, std::vector<std::string> lines, std::string const& what);
 };
 
 #endif //_BOT_MGR_H 
@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotPartyStats.h"
+#include "BotTraffic.h"
+#include "Creature.h"
+#include "GroupMgr.h"
+#include "Player.h"
+#include "StringFormat.h"
+#include "Vehicle.h"
+#include "WorldSession.h"
+
+#include <algorithm>
+
+BotPartyStats::BotPartyStats() :
+    status(0), health(0), maxHealth(0), powerType(0), power(0), maxPower(0),
+    level(0), zone(0), posX(0), posY(0), vehicleSeat(0)
+{
+}
+
+void BotPartyStats::Capture(Creature const* bot)
+{
+    status = MEMBER_STATUS_ONLINE;
+
+    if (bot->IsPvP())
+    {
+        status |= MEMBER_STATUS_PVP;
+    }
+
+    if (!bot->IsAlive())
+    {
+        status |= MEMBER_STATUS_DEAD;
+    }
+
+    if (bot->HasByteFlag(UNIT_FIELD_BYTES_2, 1, UNIT_BYTE2_FLAG_FFA_PVP))
+    {
+        status |= MEMBER_STATUS_PVP_FFA;
+    }
+
+    health = bot->GetHealth();
+    maxHealth = bot->GetMaxHealth();
+
+    Powers const type = bot->getPowerType();
+
+    powerType = uint8(type);
+    power = uint16(bot->GetPower(type));
+    maxPower = uint16(bot->GetMaxPower(type));
+    level = uint16(bot->getLevel());
+    zone = uint16(bot->GetZoneId());
+    posX = uint16(bot->GetPositionX());
+    posY = uint16(bot->GetPositionY());
+
+    if (Vehicle* veh = bot->GetVehicle())
+    {
+        vehicleSeat = veh->GetVehicleInfo()->m_seatID[bot->m_movementInfo.transport.seat];
+    }
+    else
+    {
+        vehicleSeat = 0;
+    }
+}
+
+uint32 BotPartyStats::GetChangedMask(BotPartyStats const& other) const
+{
+    uint32 mask = GROUP_UPDATE_FLAG_NONE;
+
+    if (status != other.status)
+    {
+        mask |= GROUP_UPDATE_FLAG_STATUS;
+    }
+
+    if (health != other.health)
+    {
+        mask |= GROUP_UPDATE_FLAG_CUR_HP;
+    }
+
+    if (maxHealth != other.maxHealth)
+    {
+        mask |= GROUP_UPDATE_FLAG_MAX_HP;
+    }
+
+    if (powerType != other.powerType)
+    {
+        mask |= GROUP_UPDATE_FLAG_POWER_TYPE;
+    }
+
+    if (power != other.power)
+    {
+        mask |= GROUP_UPDATE_FLAG_CUR_POWER;
+    }
+
+    if (maxPower != other.maxPower)
+    {
+        mask |= GROUP_UPDATE_FLAG_MAX_POWER;
+    }
+
+    if (level != other.level)
+    {
+        mask |= GROUP_UPDATE_FLAG_LEVEL;
+    }
+
+    if (zone != other.zone)
+    {
+        mask |= GROUP_UPDATE_FLAG_ZONE;
+    }
+
+    if (posX != other.posX || posY != other.posY)
+    {
+        mask |= GROUP_UPDATE_FLAG_POSITION;
+    }
+
+    if (vehicleSeat != other.vehicleSeat)
+    {
+        mask |= GROUP_UPDATE_FLAG_VEHICLE_SEAT;
+    }
+
+    return mask;
+}
+
+void BotPartyStats::BuildPacket(WorldPacket* data, ObjectGuid botGUID, uint32 mask) const
+{
+    if (mask & GROUP_UPDATE_FLAG_POWER_TYPE)
+    {
+        mask |= (GROUP_UPDATE_FLAG_CUR_POWER | GROUP_UPDATE_FLAG_MAX_POWER);
+    }
+
+    uint32 byteCount = 0;
+
+    for (uint8 i = 1; i < GROUP_UPDATE_FLAGS_COUNT; ++i)
+    {
+        if (mask & (1 << i))
+        {
+            byteCount += GroupUpdateLength[i];
+        }
+    }
+
+    data->Initialize(SMSG_PARTY_MEMBER_STATS, 8 + 4 + byteCount);
+    *data << botGUID.WriteAsPacked();
+    *data << uint32(mask);
+
+    if (mask & GROUP_UPDATE_FLAG_STATUS)
+    {
+        *data << uint16(status);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_CUR_HP)
+    {
+        *data << uint32(health);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_MAX_HP)
+    {
+        *data << uint32(maxHealth);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_POWER_TYPE)
+    {
+        *data << uint8(powerType);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_CUR_POWER)
+    {
+        *data << uint16(power);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_MAX_POWER)
+    {
+        *data << uint16(maxPower);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_LEVEL)
+    {
+        *data << uint16(level);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_ZONE)
+    {
+        *data << uint16(zone);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_POSITION)
+    {
+        *data << uint16(posX);
+        *data << uint16(posY);
+    }
+
+    if (mask & GROUP_UPDATE_FLAG_VEHICLE_SEAT)
+    {
+        *data << uint32(vehicleSeat);
+    }
+}
+
+void BotPartyStatsMgr::Publish(ObjectGuid::LowType groupId, ObjectGuid botGUID, ObjectGuid ownerGUID, BotPartyStats const& stats, uint32 mask)
+{
+    lock();
+
+    std::vector<PendingStats>& pending = m_groups[groupId].pending;
+    bool merged = false;
+
+    // published again before the flush, send the union of both masks
+    for (PendingStats& entry : pending)
+    {
+        if (entry.botGUID == botGUID)
+        {
+            entry.stats = stats;
+            entry.mask |= mask;
+            merged = true;
+            break;
+        }
+    }
+
+    if (!merged)
+    {
+        pending.push_back({ botGUID, ownerGUID, stats, mask });
+    }
+
+    unlock();
+}
+
+void BotPartyStatsMgr::Flush(uint32 diff)
+{
+    lock();
+
+    m_counterTime += diff;
+    m_pruneTimer += diff;
+
+    bool const prune = m_pruneTimer >= BOT_PARTY_STATS_PRUNE_INTERVAL;
+
+    if (prune)
+    {
+        m_pruneTimer = 0;
+    }
+
+    for (auto itr = m_groups.begin(); itr != m_groups.end();)
+    {
+        GroupStats& groupStats = itr->second;
+
+        // disbanded, counters included
+        Group* group = sGroupMgr->GetGroupByGUID(itr->first);
+
+        if (!group)
+        {
+            itr = m_groups.erase(itr);
+            continue;
+        }
+
+        if (prune)
+        {
+            for (auto bot = groupStats.botBytes.begin(); bot != groupStats.botBytes.end();)
+            {
+                if (group->IsMember(bot->first))
+                {
+                    ++bot;
+                }
+                else
+                {
+                    bot = groupStats.botBytes.erase(bot);
+                }
+            }
+        }
+
+        if (groupStats.pending.empty())
+        {
+            ++itr;
+            continue;
+        }
+
+        groupStats.flushing.swap(groupStats.pending);
+        groupStats.pending.clear();
+
+        size_t const count = groupStats.flushing.size();
+
+        if (groupStats.packets.size() < count)
+        {
+            groupStats.packets.resize(count);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            PendingStats const& entry = groupStats.flushing[i];
+            entry.stats.BuildPacket(&groupStats.packets[i], entry.botGUID, entry.mask);
+        }
+
+        uint32 members = 0;
+
+        for (GroupReference const* ref = group->GetFirstMember(); ref != nullptr; ref = ref->next())
+        {
+            if (Player* member = ref->GetSource())
+            {
+                ++members;
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    member->GetSession()->SendPacket(&groupStats.packets[i]);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64 const bytes = uint64(groupStats.packets[i].size()) * members;
+
+            groupStats.bytes += bytes;
+            groupStats.botBytes[groupStats.flushing[i].botGUID] += bytes;
+
+            sBotTrafficMgr->Record(
+                BOT_TRAFFIC_PARTY_MEMBER_STATS,
+                groupStats.flushing[i].botGUID,
+                groupStats.flushing[i].ownerGUID,
+                members,
+                bytes);
+        }
+
+        groupStats.packetCount += uint64(count) * members;
+
+        ++itr;
+    }
+
+    unlock();
+}
+
+void BotPartyStatsMgr::BuildSummary(std::vector<std::string>& lines)
+{
+    lock();
+
+    float const seconds = std::max<float>(m_counterTime / 1000.f, 1.f);
+
+    lines.push_back(Acore::StringFormatFmt("bot party stats traffic over the last {:.0f}s:", seconds));
+
+    for (auto const& pair : m_groups)
+    {
+        GroupStats const& groupStats = pair.second;
+
+        if (!groupStats.bytes)
+        {
+            continue;
+        }
+
+        lines.push_back(Acore::StringFormatFmt(
+            "    +-- group {}: {:.1f} bytes/s, {:.1f} packets/s, {} bots",
+            pair.first,
+            groupStats.bytes / seconds,
+            groupStats.packetCount / seconds,
+            groupStats.botBytes.size()));
+
+        for (auto const& bot : groupStats.botBytes)
+        {
+            lines.push_back(Acore::StringFormatFmt(
+                "    |   +-- {}: {:.1f} bytes/s",
+                bot.first.ToString(),
+                bot.second / seconds));
+        }
+    }
+
+    unlock();
+}
+
+void BotPartyStatsMgr::ResetCounters()
+{
+    lock();
+
+    m_counterTime = 0;
+
+    for (auto& pair : m_groups)
+    {
+        pair.second.bytes = 0;
+        pair.second.packetCount = 0;
+        pair.second.botBytes.clear();
+    }
+
+    unlock();
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_PARTY_STATS_H
+#define _BOT_PARTY_STATS_H
+
+#include "Define.h"
+#include "Group.h"
+#include "ObjectGuid.h"
+#include "WorldPacket.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Creature;
+
+// SMSG_PARTY_MEMBER_STATS fields sent for bots (bots have no pet or aura data)
+#define BOT_PARTY_STATS_FIELDS (GROUP_UPDATE_FLAG_STATUS | \
+                                GROUP_UPDATE_FLAG_CUR_HP | \
+                                GROUP_UPDATE_FLAG_MAX_HP | \
+                                GROUP_UPDATE_FLAG_POWER_TYPE | \
+                                GROUP_UPDATE_FLAG_CUR_POWER | \
+                                GROUP_UPDATE_FLAG_MAX_POWER | \
+                                GROUP_UPDATE_FLAG_LEVEL | \
+                                GROUP_UPDATE_FLAG_ZONE | \
+                                GROUP_UPDATE_FLAG_POSITION | \
+                                GROUP_UPDATE_FLAG_VEHICLE_SEAT)
+
+// full packet at least this often (ms), so members who joined or logged in
+// after the last change get every field
+#define BOT_PARTY_STATS_FULL_INTERVAL 10000
+
+// traffic counters of bots which left their group are dropped this often (ms)
+#define BOT_PARTY_STATS_PRUNE_INTERVAL 10000
+
+// party frame values of a bot, as written to SMSG_PARTY_MEMBER_STATS
+struct BotPartyStats
+{
+    BotPartyStats();
+
+    void Capture(Creature const* bot);
+
+    // GROUP_UPDATE_FLAG_* of the fields which differ from other
+    uint32 GetChangedMask(BotPartyStats const& other) const;
+
+    void BuildPacket(WorldPacket* data, ObjectGuid botGUID, uint32 mask) const;
+
+    uint16 status;
+    uint32 health;
+    uint32 maxHealth;
+    uint8 powerType;
+    uint16 power;
+    uint16 maxPower;
+    uint16 level;
+    uint16 zone;
+    uint16 posX;
+    uint16 posY;
+    uint32 vehicleSeat;
+};
+
+// Group => party frame updates of its bots.
+// Bots publish their changed fields from the map threads, the world thread
+// builds one packet per bot and sends all of them to each member of the group
+// once per world update. Buffers are kept per group and reused.
+class BotPartyStatsMgr
+{
+protected:
+    explicit BotPartyStatsMgr() { }
+
+public:
+    static BotPartyStatsMgr* instance()
+    {
+        static BotPartyStatsMgr instance;
+        return &instance;
+    }
+
+public:
+    void Publish(ObjectGuid::LowType groupId, ObjectGuid botGUID, ObjectGuid ownerGUID, BotPartyStats const& stats, uint32 mask);
+
+    // world thread, while the maps are not updating
+    void Flush(uint32 diff);
+
+    // bytes/sec sent per group and per bot since the last reset
+    void BuildSummary(std::vector<std::string>& lines);
+    void ResetCounters();
+
+private:
+    struct PendingStats
+    {
+        ObjectGuid botGUID;
+        ObjectGuid ownerGUID;
+        BotPartyStats stats;
+        uint32 mask;
+    };
+
+    struct GroupStats
+    {
+        std::vector<PendingStats> pending;
+        std::vector<PendingStats> flushing;
+        std::vector<WorldPacket> packets;
+
+        // traffic counters, bytes counted once per receiving member
+        uint64 bytes = 0;
+        uint64 packetCount = 0;
+        std::unordered_map<ObjectGuid, uint64> botBytes;
+    };
+
+    void lock()
+    {
+        m_lock.lock();
+    }
+
+    void unlock()
+    {
+        m_lock.unlock();
+    }
+
+private:
+    std::mutex m_lock;
+    std::unordered_map<ObjectGuid::LowType, GroupStats> m_groups;
+
+    // time covered by the traffic counters
+    uint32 m_counterTime = 0;
+    uint32 m_pruneTimer = 0;
+};
+
+#define sBotPartyStatsMgr BotPartyStatsMgr::instance()
+
+#endif // _BOT_PARTY_STATS_H
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotPathCache.h"
+#include "BotConfig.h"
+#include "Creature.h"
+#include "DetourNavMeshQuery.h"
+#include "Log.h"
+#include "MMapFactory.h"
+#include "Map.h"
+#include "PathGenerator.h"
+
+#include <functional>
+
+// cached paths are computed again after this long (ms)
+#define BOT_PATH_CACHE_TTL 30000
+// polygons searched around a position, as PathGenerator does (detour order: y, z, x)
+#define BOT_PATH_CACHE_EXTENT_XY 3.0f
+#define BOT_PATH_CACHE_EXTENT_Z 5.0f
+// polygons crossed by a leg check
+#define BOT_PATH_CACHE_LEG_POLYS 32
+
+namespace
+{
+    bool FindPoly(dtNavMeshQuery const* query, dtQueryFilter const& filter, float const* point, uint64& poly)
+    {
+        float const extents[3] = { BOT_PATH_CACHE_EXTENT_XY, BOT_PATH_CACHE_EXTENT_Z, BOT_PATH_CACHE_EXTENT_XY };
+        float nearest[3];
+        dtPolyRef ref = 0;
+
+        if (dtStatusFailed(query->findNearestPoly(point, extents, &filter, &ref, nearest)) || !ref)
+        {
+            return false;
+        }
+
+        poly = uint64(ref);
+
+        return true;
+    }
+
+    // straight walk on the navmesh from a point of poly to target
+    bool IsLegWalkable(dtNavMeshQuery const* query, dtQueryFilter const& filter, uint64 poly, float const* point, G3D::Vector3 const& target)
+    {
+        float const end[3] = { target.y, target.z, target.x };
+        float hitNormal[3];
+        dtPolyRef polys[BOT_PATH_CACHE_LEG_POLYS];
+        int polyCount = 0;
+        float t = 0.f;
+
+        if (dtStatusFailed(query->raycast(dtPolyRef(poly), point, end, &filter, &t, hitNormal, polys, &polyCount, BOT_PATH_CACHE_LEG_POLYS)))
+        {
+            return false;
+        }
+
+        // FLT_MAX when nothing was hit
+        return t >= 1.f;
+    }
+}
+
+size_t BotPathKeyHash::operator()(BotPathKey const& key) const
+{
+    size_t hash = std::hash<uint64>()(key.startPoly);
+
+    hash = hash * 31 + std::hash<uint64>()(key.endPoly);
+    hash = hash * 31 + std::hash<uint32>()(key.capabilities);
+
+    return hash;
+}
+
+BotPathCache::BotPathCache(Map* map) : m_map(map), m_time(0), m_hits(0), m_misses(0), m_rejects(0), m_evictions(0)
+{
+}
+
+void BotPathCache::Update(uint32 diff)
+{
+    m_time += diff;
+}
+
+bool BotPathCache::GetPath(Unit const* mover, Position const& dest, Movement::PointsArray& path)
+{
+    uint32 const capacity = sBotConfig->GetPathCacheSize();
+
+    if (!capacity)
+    {
+        return false;
+    }
+
+    dtNavMeshQuery const* query = MMAP::MMapFactory::createOrGetMMapMgr()->GetNavMeshQuery(m_map->GetId(), m_map->GetInstanceId());
+
+    if (!query)
+    {
+        return false;
+    }
+
+    // polygons are looked up with every area allowed, the capabilities part of the key keeps
+    // paths of walkers, swimmers and flyers apart
+    dtQueryFilter filter;
+
+    float const start[3] = { mover->GetPositionY(), mover->GetPositionZ(), mover->GetPositionX() };
+    float const end[3] = { dest.GetPositionY(), dest.GetPositionZ(), dest.GetPositionX() };
+
+    BotPathKey key;
+    key.capabilities = GetCapabilities(mover);
+
+    if (!FindPoly(query, filter, start, key.startPoly) || !FindPoly(query, filter, end, key.endPoly))
+    {
+        return false;
+    }
+
+    // replayed by the path cache bench, see test/BotPathCacheTest.cpp
+    LOG_TRACE("npcbots", "path cache lookup: {} {} {}", key.startPoly, key.endPoly, key.capabilities);
+
+    if (Movement::PointsArray const* cached = Find(key))
+    {
+        // the cached path started and ended elsewhere in the same polygons
+        if (IsLegWalkable(query, filter, key.startPoly, start, (*cached)[1]) &&
+            (cached->size() == 2 || IsLegWalkable(query, filter, key.endPoly, end, (*cached)[cached->size() - 2])))
+        {
+            path = *cached;
+            path.front() = G3D::Vector3(mover->GetPositionX(), mover->GetPositionY(), mover->GetPositionZ());
+            path.back() = G3D::Vector3(dest.GetPositionX(), dest.GetPositionY(), dest.GetPositionZ());
+
+            return true;
+        }
+
+        ++m_rejects;
+    }
+
+    PathGenerator generator(mover);
+    bool const result = generator.CalculatePath(dest.GetPositionX(), dest.GetPositionY(), dest.GetPositionZ());
+
+    if (!result || (generator.GetPathType() & PATHFIND_NOPATH) || generator.GetPath().size() < 2)
+    {
+        return false;
+    }
+
+    path = generator.GetPath();
+
+    // incomplete paths are used once, not shared
+    if (generator.GetPathType() & PATHFIND_NORMAL)
+    {
+        Insert(key, path, capacity);
+    }
+
+    return true;
+}
+
+Movement::PointsArray const* BotPathCache::Find(BotPathKey const& key)
+{
+    auto itr = m_index.find(key);
+
+    if (itr == m_index.end())
+    {
+        ++m_misses;
+        return nullptr;
+    }
+
+    if (m_time - itr->second->time > BOT_PATH_CACHE_TTL)
+    {
+        // expired paths count as evictions
+        ++m_misses;
+        ++m_evictions;
+
+        m_entries.erase(itr->second);
+        m_index.erase(itr);
+
+        return nullptr;
+    }
+
+    ++m_hits;
+
+    m_entries.splice(m_entries.begin(), m_entries, itr->second);
+
+    return &itr->second->path;
+}
+
+void BotPathCache::Insert(BotPathKey const& key, Movement::PointsArray const& path, uint32 capacity)
+{
+    if (!capacity || path.size() < 2)
+    {
+        return;
+    }
+
+    auto itr = m_index.find(key);
+
+    if (itr != m_index.end())
+    {
+        // a rejected hit, the new path replaces it
+        itr->second->time = m_time;
+        itr->second->path = path;
+
+        m_entries.splice(m_entries.begin(), m_entries, itr->second);
+
+        return;
+    }
+
+    m_entries.push_front({ key, m_time, path });
+    m_index[key] = m_entries.begin();
+
+    while (m_index.size() > capacity)
+    {
+        ++m_evictions;
+
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+}
+
+uint32 BotPathCache::GetCapabilities(Unit const* mover)
+{
+    uint32 capabilities = 0;
+
+    if (Creature const* creature = mover->ToCreature())
+    {
+        capabilities |= creature->CanWalk() ? BOT_PATH_CAN_WALK : 0;
+        capabilities |= creature->CanSwim() ? BOT_PATH_CAN_SWIM : 0;
+        capabilities |= creature->CanFly() ? BOT_PATH_CAN_FLY : 0;
+    }
+    else
+    {
+        capabilities |= BOT_PATH_CAN_WALK | BOT_PATH_CAN_SWIM;
+    }
+
+    capabilities |= mover->IsInWater() ? BOT_PATH_IN_WATER : 0;
+    capabilities |= mover->IsFlying() ? BOT_PATH_FLYING : 0;
+
+    return capabilities;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_PATH_CACHE_H
+#define _BOT_PATH_CACHE_H
+
+#include "Define.h"
+#include "MoveSplineInitArgs.h"
+
+#include <list>
+#include <unordered_map>
+
+class Map;
+class Unit;
+struct Position;
+
+enum BotPathCapabilities
+{
+    BOT_PATH_CAN_WALK                   = 0x01,
+    BOT_PATH_CAN_SWIM                   = 0x02,
+    BOT_PATH_CAN_FLY                    = 0x04,
+    BOT_PATH_IN_WATER                   = 0x08,
+    BOT_PATH_FLYING                     = 0x10
+};
+
+// navmesh polygons of the start and the destination, movement capabilities of the mover
+struct BotPathKey
+{
+    uint64 startPoly;
+    uint64 endPoly;
+    uint32 capabilities;
+
+    bool operator==(BotPathKey const& other) const
+    {
+        return startPoly == other.startPoly && endPoly == other.endPoly && capabilities == other.capabilities;
+    }
+};
+
+struct BotPathKeyHash
+{
+    size_t operator()(BotPathKey const& key) const;
+};
+
+// Paths computed for BotAI::BotMovement(...), reused by any bot of the map
+// moving between the same navmesh polygons (NpcBots.PathCache.Size).
+// Finding the polygons of both ends is a nearest poly lookup, far cheaper than
+// the path query it saves. A hit is replayed from the exact position of the
+// mover to the exact destination, once the navmesh confirms the first and the
+// last leg are walkable from there. The least recently used path is evicted
+// when the cache is full, paths older than BOT_PATH_CACHE_TTL are computed
+// again so doors and other dynamic objects are seen.
+//
+// Owned by BotMapData, only used from the thread updating the map.
+class BotPathCache
+{
+public:
+    explicit BotPathCache(Map* map);
+
+public:
+    void Update(uint32 diff);
+
+    // path from the mover to dest, false if none can be reused or computed (the caller paths on its own)
+    bool GetPath(Unit const* mover, Position const& dest, Movement::PointsArray& path);
+
+    // least recently used cache itself, keyed by the caller
+    Movement::PointsArray const* Find(BotPathKey const& key);
+    void Insert(BotPathKey const& key, Movement::PointsArray const& path, uint32 capacity);
+
+    uint64 GetHits() const { return m_hits; }
+    uint64 GetMisses() const { return m_misses; }
+    uint64 GetRejects() const { return m_rejects; }
+    uint64 GetEvictions() const { return m_evictions; }
+    uint32 GetSize() const { return uint32(m_index.size()); }
+
+    static uint32 GetCapabilities(Unit const* mover);
+
+private:
+    struct Entry
+    {
+        BotPathKey key;
+        uint32 time;
+        Movement::PointsArray path;
+    };
+
+private:
+    Map* m_map;
+    uint32 m_time;
+
+    // most recently used first
+    std::list<Entry> m_entries;
+    std::unordered_map<BotPathKey, std::list<Entry>::iterator, BotPathKeyHash> m_index;
+
+    uint64 m_hits;
+    uint64 m_misses;
+    // hits not replayed, a leg from the exact start or destination was blocked
+    uint64 m_rejects;
+    uint64 m_evictions;
+};
+
+#endif // _BOT_PATH_CACHE_H
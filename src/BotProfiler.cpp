@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotProfiler.h"
+
+#include <algorithm>
+
+void BotPhaseHistogram::Reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_total = 0;
+    m_max = 0;
+}
+
+uint64 BotPhaseHistogram::GetPercentile(float pct) const
+{
+    if (!m_count)
+    {
+        return 0;
+    }
+
+    uint64 rank = std::max<uint64>(uint64(m_count * pct), 1);
+    uint64 seen = 0;
+
+    for (uint32 bucket = 0; bucket < BUCKETS; ++bucket)
+    {
+        seen += m_buckets[bucket];
+
+        if (seen >= rank)
+        {
+            return std::min<uint64>((uint64(1) << (bucket + 1)) - 1, m_max);
+        }
+    }
+
+    return m_max;
+}
+
+void BotProfiler::Reset()
+{
+    for (BotPhaseHistogram& phase : m_phases)
+    {
+        phase.Reset();
+    }
+}
+
+char const* BotProfiler::GetPhaseName(BotProfilePhase phase)
+{
+    switch (phase)
+    {
+    case BOT_PROFILE_FOLLOWER:
+        return "follower";
+    case BOT_PROFILE_GROUP_UPDATE:
+        return "group_update";
+    case BOT_PROFILE_REGENERATE:
+        return "regenerate";
+    case BOT_PROFILE_RATIONS:
+        return "rations";
+    case BOT_PROFILE_MOUNT:
+        return "mount";
+    case BOT_PROFILE_STAND:
+        return "stand";
+    case BOT_PROFILE_COMBAT:
+        return "combat";
+    case BOT_PROFILE_TARGET_SEARCH:
+        return "target_search";
+    case BOT_PROFILE_CAST:
+        return "cast";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_PROFILER_H
+#define _BOT_PROFILER_H
+
+#include "Define.h"
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// build with -DNPCBOTS_PROFILER=0 to compile all BOT_PROFILE_SCOPE(...) out
+#ifndef NPCBOTS_PROFILER
+#define NPCBOTS_PROFILER 1
+#endif
+
+enum BotProfilePhase
+{
+    BOT_PROFILE_FOLLOWER                = 0,    // UpdateFollowerAI
+    BOT_PROFILE_GROUP_UPDATE            = 1,    // party member stats packet build + send
+    BOT_PROFILE_REGENERATE              = 2,
+    BOT_PROFILE_RATIONS                 = 3,    // UpdateBotRations
+    BOT_PROFILE_MOUNT                   = 4,    // UpdateMountedState
+    BOT_PROFILE_STAND                   = 5,    // UpdateStandState
+    BOT_PROFILE_COMBAT                  = 6,    // UpdateBotCombatAI, includes the two below
+    BOT_PROFILE_TARGET_SEARCH           = 7,
+    BOT_PROFILE_CAST                    = 8,
+
+    BOT_PROFILE_MAX
+};
+
+// Log2 histogram of phase durations in nanoseconds.
+// Percentiles are reported as the upper bound of the bucket they fall in.
+class BotPhaseHistogram
+{
+public:
+    BotPhaseHistogram() { Reset(); }
+
+public:
+    void Record(uint64 ns)
+    {
+        uint32 bucket = 0;
+
+        for (uint64 v = ns; v > 1 && bucket < BUCKETS - 1; v >>= 1)
+        {
+            ++bucket;
+        }
+
+        ++m_buckets[bucket];
+        ++m_count;
+        m_total += ns;
+
+        if (ns > m_max)
+        {
+            m_max = ns;
+        }
+    }
+
+    void Reset();
+
+    uint64 GetCount() const { return m_count; }
+    uint64 GetMean() const { return m_count ? m_total / m_count : 0; }
+    uint64 GetMax() const { return m_max; }
+    uint64 GetPercentile(float pct) const;
+
+private:
+    static constexpr uint32 BUCKETS = 48;
+
+    std::array<uint64, BUCKETS> m_buckets;
+    uint64 m_count;
+    uint64 m_total;
+    uint64 m_max;
+};
+
+// Per-map phase timings, owned by BotMapData.
+// Written by the thread updating the map, read by commands on the world thread,
+// which only run while no map is updating.
+class BotProfiler
+{
+public:
+    void Record(BotProfilePhase phase, uint64 ns) { m_phases[phase].Record(ns); }
+    void Reset();
+
+    BotPhaseHistogram const& GetPhase(BotProfilePhase phase) const { return m_phases[phase]; }
+
+    static char const* GetPhaseName(BotProfilePhase phase);
+
+private:
+    std::array<BotPhaseHistogram, BOT_PROFILE_MAX> m_phases;
+};
+
+class BotProfileScope
+{
+public:
+    BotProfileScope(BotProfiler* profiler, BotProfilePhase phase) : m_profiler(profiler), m_phase(phase)
+    {
+        if (m_profiler)
+        {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~BotProfileScope()
+    {
+        if (m_profiler)
+        {
+            m_profiler->Record(m_phase, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+        }
+    }
+
+private:
+    BotProfileScope(BotProfileScope const&) = delete;
+    BotProfileScope& operator=(BotProfileScope const&) = delete;
+
+private:
+    BotProfiler* m_profiler;
+    BotProfilePhase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#define BOT_PROFILE_CONCAT_INNER(a, b) a##b
+#define BOT_PROFILE_CONCAT(a, b) BOT_PROFILE_CONCAT_INNER(a, b)
+
+// times the rest of the enclosing block. profiler may be null (not profiled).
+#if NPCBOTS_PROFILER
+#define BOT_PROFILE_SCOPE(profiler, phase) BotProfileScope BOT_PROFILE_CONCAT(_botProfileScope, __LINE__)(profiler, phase)
+#else
+#define BOT_PROFILE_SCOPE(profiler, phase)
+#endif
+
+#endif // _BOT_PROFILER_H
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_RANDOM_H
+#define _BOT_RANDOM_H
+
+#include "Define.h"
+
+// Small per-bot pseudo random generator (xoshiro128**).
+// Each BotAI owns one, so bots never share random state across map threads and
+// never touch the core's generator on the hot path. With a fixed seed a bot
+// makes the same decisions in the same situations on every run.
+class BotRandom
+{
+public:
+    BotRandom() { Seed(0); }
+    explicit BotRandom(uint64 seed) { Seed(seed); }
+
+public:
+    // state is expanded from the seed with splitmix64, any seed (even 0) is fine
+    void Seed(uint64 seed)
+    {
+        for (uint32 i = 0; i < 4; i += 2)
+        {
+            uint64 z = SplitMix64(seed);
+
+            m_state[i] = uint32(z);
+            m_state[i + 1] = uint32(z >> 32);
+        }
+    }
+
+    uint32 Next()
+    {
+        uint32 result = Rotl(m_state[1] * 5, 7) * 9;
+        uint32 t = m_state[1] << 9;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = Rotl(m_state[3], 11);
+
+        return result;
+    }
+
+    // uniform in [min, max], same contract as urand(min, max)
+    uint32 URand(uint32 min, uint32 max)
+    {
+        if (max <= min)
+        {
+            return min;
+        }
+
+        uint64 range = uint64(max - min) + 1;
+
+        return min + uint32((uint64(Next()) * range) >> 32);
+    }
+
+    static uint64 SplitMix64(uint64& x)
+    {
+        uint64 z = (x += 0x9E3779B97F4A7C15ULL);
+
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+        return z ^ (z >> 31);
+    }
+
+private:
+    static uint32 Rotl(uint32 x, int k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+
+private:
+    uint32 m_state[4];
+};
+
+#endif // _BOT_RANDOM_H
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotRegenBatch.h"
+#include "BotAI.h"
+#include "BotCommon.h"
+#include "BotConfig.h"
+#include "BotTraffic.h"
+#include "Creature.h"
+#include "Map.h"
+#include "World.h"
+
+#include <algorithm>
+
+BotRegenBatch::BotRegenBatch(Map* map, BotTrafficBuffer& traffic) : m_map(map), m_traffic(traffic), m_regenTimer(0), m_manaRate(0.f)
+{
+}
+
+void BotRegenBatch::Register(ObjectGuid botGUID)
+{
+    // a bot may come back before the pass pruned it
+    if (std::find(m_bots.begin(), m_bots.end(), botGUID) == m_bots.end())
+    {
+        m_bots.push_back(botGUID);
+    }
+}
+
+void BotRegenBatch::Update(uint32 diff)
+{
+    if (!sBotConfig->IsRegenBatchEnabled())
+    {
+        m_regenTimer = 0;
+        return;
+    }
+
+    m_regenTimer += diff;
+
+    if (m_regenTimer < REGEN_CD)
+    {
+        return;
+    }
+
+    m_regenTimer %= REGEN_CD;
+
+    Gather();
+    Compute();
+    WriteBack();
+}
+
+void BotRegenBatch::Gather()
+{
+    m_creatures.clear();
+    m_health.clear();
+    m_maxHealth.clear();
+    m_createHealth.clear();
+    m_baseRegen.clear();
+    m_isInCombat.clear();
+    m_isPolymorphed.clear();
+    m_isFreeIdle.clear();
+    m_healthRegenMult.clear();
+    m_healthRegenMod.clear();
+    m_inCombatPct.clear();
+    m_inCombatMod.clear();
+    m_hasInCombatPct.clear();
+    m_hasInCombatMod.clear();
+    m_mana.clear();
+    m_maxMana.clear();
+    m_manaFlatRegen.clear();
+
+    m_manaRate = sWorld->getRate(RATE_POWER_MANA) * float(REGEN_CD) * 0.001f;
+
+    for (size_t i = 0; i < m_bots.size();)
+    {
+        // the bot may have despawned or left the map.
+        // only bots register, a creature of a registered guid always runs a BotAI.
+        Creature* bot = m_map->GetCreature(m_bots[i]);
+        BotAI* ai = bot ? static_cast<BotAI*>(bot->AI()) : nullptr;
+
+        if (!ai)
+        {
+            m_bots[i] = m_bots.back();
+            m_bots.pop_back();
+            continue;
+        }
+
+        ++i;
+
+        if (!bot->IsAlive())
+        {
+            continue;
+        }
+
+        if (ai->m_isRegenAuraCacheDirty)
+        {
+            ai->UpdateRegenAuraCache();
+        }
+
+        m_creatures.push_back(bot);
+        m_health.push_back(bot->GetHealth());
+        m_maxHealth.push_back(bot->GetMaxHealth());
+        m_createHealth.push_back(bot->GetCreateHealth());
+        m_baseRegen.push_back(int32(ai->GetTotalBotStat(BOT_STAT_MOD_HEALTH_REGEN)));
+        m_isInCombat.push_back(bot->IsInCombat());
+        m_isPolymorphed.push_back(bot->IsPolymorphed());
+        m_isFreeIdle.push_back(ai->IAmFree() && !bot->GetVictim());
+        m_healthRegenMult.push_back(ai->m_healthRegenMult);
+        m_healthRegenMod.push_back(ai->m_healthRegenMod);
+        m_inCombatPct.push_back(ai->m_healthRegenInCombatPct);
+        m_inCombatMod.push_back(ai->m_healthRegenInCombatMod);
+        m_hasInCombatPct.push_back(ai->m_hasHealthRegenInCombatPct);
+        m_hasInCombatMod.push_back(ai->m_hasHealthRegenInCombatMod);
+        m_mana.push_back(bot->GetPower(POWER_MANA));
+        m_maxMana.push_back(bot->GetMaxPower(POWER_MANA));
+        m_manaFlatRegen.push_back(bot->GetFloatValue(bot->IsUnderLastManaUseEffect() ?
+            UNIT_FIELD_POWER_REGEN_INTERRUPTED_FLAT_MODIFIER :
+            UNIT_FIELD_POWER_REGEN_FLAT_MODIFIER));
+    }
+}
+
+// BotAI::CalculateHealthRegen() and CalculateManaRegen() over the gathered arrays.
+// every branch of the per bot functions is a select here, the compiler can vectorize it.
+void BotRegenBatch::Compute()
+{
+    size_t const count = m_creatures.size();
+
+    m_healthRegen.resize(count);
+    m_manaRegen.resize(count);
+
+    uint32 const* health = m_health.data();
+    uint32 const* maxHealth = m_maxHealth.data();
+    uint32 const* createHealth = m_createHealth.data();
+    int32 const* baseRegen = m_baseRegen.data();
+    uint8 const* isInCombat = m_isInCombat.data();
+    uint8 const* isPolymorphed = m_isPolymorphed.data();
+    uint8 const* isFreeIdle = m_isFreeIdle.data();
+    float const* healthRegenMult = m_healthRegenMult.data();
+    int32 const* healthRegenMod = m_healthRegenMod.data();
+    int32 const* inCombatPct = m_inCombatPct.data();
+    int32 const* inCombatMod = m_inCombatMod.data();
+    uint8 const* hasInCombatPct = m_hasInCombatPct.data();
+    uint8 const* hasInCombatMod = m_hasInCombatMod.data();
+    uint32 const* mana = m_mana.data();
+    uint32 const* maxMana = m_maxMana.data();
+    float const* manaFlatRegen = m_manaFlatRegen.data();
+    float const manaRate = m_manaRate;
+    uint32* healthRegen = m_healthRegen.data();
+    uint32* manaRegen = m_manaRegen.data();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        bool const combat = isInCombat[i];
+        bool const poly = isPolymorphed[i];
+
+        int32 add = combat ? 0 : isFreeIdle[i] ? int32(maxHealth[i] / 32) : 5 + int32(createHealth[i] / 256);
+        add += baseRegen[i] > 0 ? std::max<int32>(baseRegen[i] / 5, 1) : 0;
+
+        int32 const outOfCombatAdd = int32(add * healthRegenMult[i]) + healthRegenMod[i] * REGEN_CD / 5000;
+        int32 const inCombatAdd = hasInCombatPct[i] ? int32(add * float(inCombatPct[i]) / 100.0f) : add;
+
+        add = poly ? add + int32(maxHealth[i] / 6) : combat ? inCombatAdd : outOfCombatAdd;
+        add += inCombatMod[i];
+
+        bool const noHealthRegen = health[i] >= maxHealth[i] ||
+            (combat && !poly && baseRegen[i] <= 0 && !hasInCombatPct[i] && !hasInCombatMod[i]);
+
+        healthRegen[i] = noHealthRegen || add <= 0 ? 0 : uint32(add);
+
+        float const addMana = manaFlatRegen[i] * manaRate;
+        bool const noManaRegen = maxMana[i] <= 1 || mana[i] >= maxMana[i];
+
+        manaRegen[i] = noManaRegen || addMana <= 0.0f ? 0 : uint32(addMana);
+    }
+}
+
+// deltas, like the per bot path: ModifyHealth / ModifyPower clamp to the current maximum
+void BotRegenBatch::WriteBack()
+{
+    for (size_t i = 0; i < m_creatures.size(); ++i)
+    {
+        uint32 writes = 0;
+
+        if (m_healthRegen[i])
+        {
+            m_creatures[i]->ModifyHealth(int32(m_healthRegen[i]));
+            ++writes;
+        }
+
+        if (m_manaRegen[i])
+        {
+            m_creatures[i]->ModifyPower(POWER_MANA, int32(m_manaRegen[i]));
+            ++writes;
+        }
+
+        if (writes)
+        {
+            m_traffic.Record(
+                BOT_TRAFFIC_UPDATE_FIELDS,
+                m_creatures[i]->GetGUID(),
+                m_creatures[i]->GetOwnerGUID(),
+                0,
+                uint64(writes) * BOT_TRAFFIC_UPDATE_FIELD_BYTES);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_REGEN_BATCH_H
+#define _BOT_REGEN_BATCH_H
+
+#include "Define.h"
+#include "ObjectGuid.h"
+
+#include <vector>
+
+class BotTrafficBuffer;
+class Creature;
+class Map;
+
+// Map level health / mana regeneration pass (NpcBots.Regen.Batch).
+// Once per REGEN_CD the raw regen inputs of every bot on the map (health, mana,
+// combat state, cached regen stat and aura totals) are gathered into flat
+// arrays, the regen amounts of BotAI::CalculateHealthRegen() and
+// CalculateManaRegen() are computed for all bots in one branch free loop and
+// only non zero amounts are written back, as deltas. Energy still regenerates
+// in each bot's own update since it ticks every frame.
+//
+// Owned by BotMapData, only used from the thread updating the map.
+class BotRegenBatch
+{
+public:
+    explicit BotRegenBatch(Map* map, BotTrafficBuffer& traffic);
+
+public:
+    void Update(uint32 diff);
+
+    // called by a bot when it starts updating on the map
+    void Register(ObjectGuid botGUID);
+
+    uint32 GetBotCount() const { return uint32(m_bots.size()); }
+
+private:
+    void Gather();
+    void Compute();
+    void WriteBack();
+
+private:
+    Map* m_map;
+    BotTrafficBuffer& m_traffic;
+    uint32 m_regenTimer;
+
+    // bots registered on the map, pruned when they leave it
+    std::vector<ObjectGuid> m_bots;
+
+    // gathered inputs, one entry per living bot
+    std::vector<Creature*> m_creatures;
+    std::vector<uint32> m_health;
+    std::vector<uint32> m_maxHealth;
+    std::vector<uint32> m_createHealth;
+    std::vector<int32> m_baseRegen;             // BOT_STAT_MOD_HEALTH_REGEN
+    std::vector<uint8> m_isInCombat;
+    std::vector<uint8> m_isPolymorphed;
+    std::vector<uint8> m_isFreeIdle;            // free bot without a victim
+    std::vector<float> m_healthRegenMult;       // SPELL_AURA_MOD_HEALTH_REGEN_PERCENT
+    std::vector<int32> m_healthRegenMod;        // SPELL_AURA_MOD_REGEN
+    std::vector<int32> m_inCombatPct;           // SPELL_AURA_MOD_REGEN_DURING_COMBAT
+    std::vector<int32> m_inCombatMod;           // SPELL_AURA_MOD_HEALTH_REGEN_IN_COMBAT
+    std::vector<uint8> m_hasInCombatPct;
+    std::vector<uint8> m_hasInCombatMod;
+    std::vector<uint32> m_mana;
+    std::vector<uint32> m_maxMana;
+    std::vector<float> m_manaFlatRegen;         // UNIT_FIELD_POWER_REGEN_(INTERRUPTED_)FLAT_MODIFIER
+    float m_manaRate;
+
+    // computed amounts
+    std::vector<uint32> m_healthRegen;
+    std::vector<uint32> m_manaRegen;
+};
+
+#endif // _BOT_REGEN_BATCH_H
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotAI.h"
+#include "BotConfig.h"
+#include "BotScheduler.h"
+#include "Creature.h"
+#include "Map.h"
+
+#include <algorithm>
+
+BotScheduler::BotScheduler(Map* map)
+{
+    m_map = map;
+
+    m_time = 0;
+    m_cursorTime = 0;
+    m_queued = 0;
+}
+
+void BotScheduler::Schedule(ObjectGuid botGUID, uint32 token, uint32 delay, uint8 priority)
+{
+    Item item;
+    item.botGUID = botGUID;
+    item.token = token;
+    item.dueTime = m_time + delay;
+    item.priority = priority;
+    item.rollovers = 0;
+
+    // anything already expired by the cursor is picked up by the next update
+    uint32 slotTime = std::max(item.dueTime, m_cursorTime);
+
+    m_wheel[(slotTime / WHEEL_GRANULARITY) % WHEEL_SLOTS].push_back(item);
+    ++m_queued;
+}
+
+void BotScheduler::Update(uint32 diff)
+{
+    m_time += diff;
+
+    // expire every wheel slot that ended before now. items further away than
+    // one wheel turn stay in their slot until the cursor comes around again.
+    uint32 expired = 0;
+
+    while (m_cursorTime + WHEEL_GRANULARITY <= m_time && expired < WHEEL_SLOTS)
+    {
+        std::vector<Item>& slot = m_wheel[(m_cursorTime / WHEEL_GRANULARITY) % WHEEL_SLOTS];
+
+        for (uint32 i = 0; i < slot.size(); )
+        {
+            if (slot[i].dueTime <= m_time)
+            {
+                m_ready.push_back(slot[i]);
+                slot[i] = slot.back();
+                slot.pop_back();
+                --m_queued;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        m_cursorTime += WHEEL_GRANULARITY;
+        ++expired;
+    }
+
+    // after a long stall skip the cursor forward, the slots were all visited once
+    if (m_cursorTime + WHEEL_GRANULARITY <= m_time)
+    {
+        m_cursorTime = m_time - m_time % WHEEL_GRANULARITY;
+    }
+
+    if (m_ready.empty())
+    {
+        return;
+    }
+
+    std::sort(m_ready.begin(), m_ready.end(), [](Item const& a, Item const& b)
+    {
+        if (a.GetEffectivePriority() != b.GetEffectivePriority())
+        {
+            return a.GetEffectivePriority() < b.GetEffectivePriority();
+        }
+
+        return a.dueTime < b.dueTime;
+    });
+
+    uint32 budget = sBotConfig->GetSchedulerThinkBudget();
+    uint32 granted = budget ? std::min<uint32>(budget, m_ready.size()) : m_ready.size();
+
+    for (uint32 i = 0; i < granted; ++i)
+    {
+        Grant(m_ready[i]);
+    }
+
+    m_ready.erase(m_ready.begin(), m_ready.begin() + granted);
+
+    for (Item& item : m_ready)
+    {
+        if (item.rollovers < 0xFF)
+        {
+            ++item.rollovers;
+        }
+    }
+}
+
+void BotScheduler::Grant(Item const& item)
+{
+    // the bot may have despawned or left the map since it was queued
+    Creature* bot = m_map->GetCreature(item.botGUID);
+
+    if (!bot)
+    {
+        return;
+    }
+
+    if (BotAI* ai = dynamic_cast<BotAI*>(bot->AI()))
+    {
+        ai->OnThinkTickGranted(item.token);
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_SCHEDULER_H
+#define _BOT_SCHEDULER_H
+
+#include "Define.h"
+#include "ObjectGuid.h"
+
+#include <array>
+#include <vector>
+
+class Map;
+
+enum BotThinkPriority
+{
+    BOT_THINK_PRIORITY_COMBAT           = 0,
+    BOT_THINK_PRIORITY_FOLLOWER         = 1,
+    BOT_THINK_PRIORITY_IDLE             = 2
+};
+
+enum BotThinkState
+{
+    BOT_THINK_STATE_NONE                = 0,    // not queued on the bot's current map
+    BOT_THINK_STATE_QUEUED              = 1,
+    BOT_THINK_STATE_GRANTED             = 2     // runs the think pipeline on its next update
+};
+
+// Per-map think tick scheduler.
+// Bots queue their next think time in a timing wheel. Each map update the due
+// bots are moved to a ready list and granted think ticks in priority order, at
+// most NpcBots.Scheduler.ThinkBudget per frame. Bots that do not fit roll over
+// to the next frame ahead of newly due bots of the same priority and gain one
+// priority level per frame they wait, so idle bots are delayed but never starved.
+//
+// Owned by BotMapData, only used from the thread updating the map.
+class BotScheduler
+{
+public:
+    explicit BotScheduler(Map* map);
+
+public:
+    void Update(uint32 diff);
+    void Schedule(ObjectGuid botGUID, uint32 token, uint32 delay, uint8 priority);
+
+    uint32 GetTime() const { return m_time; }
+    uint32 GetQueuedCount() const { return m_queued; }
+    uint32 GetReadyCount() const { return m_ready.size(); }
+
+private:
+    struct Item
+    {
+        ObjectGuid botGUID;
+        uint32 token;       // BotAI think token the item was queued with
+        uint32 dueTime;
+        uint8 priority;
+        uint8 rollovers;    // frames spent in the ready list
+
+        uint8 GetEffectivePriority() const { return priority > rollovers ? priority - rollovers : 0; }
+    };
+
+    static constexpr uint32 WHEEL_SLOTS = 64;
+    static constexpr uint32 WHEEL_GRANULARITY = 50; // ms per wheel slot
+
+    void Grant(Item const& item);
+
+private:
+    Map* m_map;
+
+    uint32 m_time;
+    uint32 m_cursorTime;    // start time of the next wheel slot to expire
+    uint32 m_queued;
+
+    std::array<std::vector<Item>, WHEEL_SLOTS> m_wheel;
+    std::vector<Item> m_ready;
+};
+
+#endif // _BOT_SCHEDULER_H
@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotSelfCheck.h"
+#include "BotCommon.h"
+#include "BotEpoch.h"
+#include "BotMgr.h"
+#include "Log.h"
+#include "StringFormat.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <unordered_map>
+
+// benchmarks
+#define SELF_CHECK_BENCH_OPS 200000
+#define SELF_CHECK_BENCH_OWNERS 8
+#define SELF_CHECK_BENCH_TICKS 200000
+#define SELF_CHECK_BENCH_SPELLS 16
+
+namespace
+{
+    // stored and compared by the registry, never dereferenced
+    BotAI* GetFakeAI(ObjectGuid botGUID)
+    {
+        return reinterpret_cast<BotAI*>(uintptr_t(botGUID.GetCounter()) << 4);
+    }
+
+    ObjectGuid GetFakeOwner(uint32 roll)
+    {
+        return ObjectGuid::Create<HighGuid::Player>(1 + roll % SELF_CHECK_BENCH_OWNERS);
+    }
+
+    // ns per op
+    template<typename Fn>
+    double Measure(uint32 ops, Fn&& fn)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        fn();
+        auto const end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / std::max<uint32>(ops, 1);
+    }
+
+    // keeps benchmarked reads from being optimized out
+    std::atomic<uintptr_t> benchSink;
+}
+
+void BotSelfCheck::Run()
+{
+    std::vector<std::string> lines;
+    bool ok = true;
+
+    ok = BenchRegistry(lines) && ok;
+    ok = BenchSpellBook(lines) && ok;
+
+    for (std::string const& line : lines)
+    {
+        LOG_INFO("npcbots", "self check: {}", line);
+    }
+
+    if (!ok)
+    {
+        LOG_ERROR("npcbots", "self check: FAILED, see the npcbots log.");
+    }
+}
+
+bool BotSelfCheck::BenchRegistry(std::vector<std::string>& lines)
+{
+    // layout of the old registry entries
+    struct MapEntry
+    {
+        BotAI* ai;
+        ObjectGuid botGUID;
+        ObjectGuid ownerGUID;
+        uint32 creatureEntry;
+    };
+
+    for (uint32 count : { 100, 1000, 10000 })
+    {
+        std::vector<ObjectGuid> guids;
+        guids.reserve(count);
+
+        for (uint32 i = 1; i <= count; ++i)
+        {
+            guids.push_back(ObjectGuid::Create<HighGuid::Unit>(BOT_DREADLORD, i));
+        }
+
+        uint32 const rounds = std::max<uint32>(SELF_CHECK_BENCH_OPS / count, 1);
+        uintptr_t sink = 0;
+
+        // flat registry
+        BotsRegistry registry;
+
+        double const flatInsert = Measure(count, [&]()
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                registry.RegisterEntry(GetFakeAI(guids[i]), guids[i], GetFakeOwner(i), BOT_DREADLORD);
+            }
+        });
+
+        double const flatLookup = Measure(count * rounds, [&]()
+        {
+            BotsRegistrySnapshotRef snapshot = registry.GetSnapshot();
+
+            for (uint32 round = 0; round < rounds; ++round)
+            {
+                for (ObjectGuid guid : guids)
+                {
+                    sink += uintptr_t(snapshot->Find(guid)->GetBotAI());
+                }
+            }
+        });
+
+        double const flatIterate = Measure(count * rounds, [&]()
+        {
+            BotsRegistrySnapshotRef snapshot = registry.GetSnapshot();
+
+            for (uint32 round = 0; round < rounds; ++round)
+            {
+                for (BotEntry const& entry : snapshot->GetEntries())
+                {
+                    sink += uintptr_t(entry.GetBotAI());
+                }
+            }
+        });
+
+        // std::map of heap entries
+        std::map<ObjectGuid, MapEntry*> entries;
+
+        double const mapInsert = Measure(count, [&]()
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                entries[guids[i]] = new MapEntry{ GetFakeAI(guids[i]), guids[i], GetFakeOwner(i), BOT_DREADLORD };
+            }
+        });
+
+        double const mapLookup = Measure(count * rounds, [&]()
+        {
+            for (uint32 round = 0; round < rounds; ++round)
+            {
+                for (ObjectGuid guid : guids)
+                {
+                    sink += uintptr_t(entries.find(guid)->second->ai);
+                }
+            }
+        });
+
+        double const mapIterate = Measure(count * rounds, [&]()
+        {
+            for (uint32 round = 0; round < rounds; ++round)
+            {
+                for (auto const& pair : entries)
+                {
+                    sink += uintptr_t(pair.second->ai);
+                }
+            }
+        });
+
+        for (auto const& pair : entries)
+        {
+            delete pair.second;
+        }
+
+        benchSink += sink;
+
+        lines.push_back(Acore::StringFormatFmt(
+            "registry bench {:>5} bots (ns/op, flat vs std::map): insert {:.1f} / {:.1f}, lookup {:.1f} / {:.1f}, iterate {:.1f} / {:.1f}",
+            count, flatInsert, mapInsert, flatLookup, mapLookup, flatIterate, mapIterate));
+    }
+
+    return true;
+}
+
+bool BotSelfCheck::BenchSpellBook(std::vector<std::string>& lines)
+{
+    // layout of BotAI::BotSpell and BotAI::BotSpellIndex
+    struct Spell
+    {
+        uint32 spellId;
+        uint32 readyTime;
+        bool enabled;
+    };
+
+    struct SpellIndex
+    {
+        uint32 basespell;
+        uint32 slot;
+    };
+
+    std::vector<uint32> basespells;
+
+    for (uint32 i = 0; i < SELF_CHECK_BENCH_SPELLS; ++i)
+    {
+        basespells.push_back(1000 + i * 37);
+    }
+
+    // per tick: ready check and spell id of every spell, a cooldown set every 8th tick
+    uintptr_t sink = 0;
+
+    std::unordered_map<uint32, Spell*> spellMap;
+
+    for (uint32 basespell : basespells)
+    {
+        spellMap[basespell] = new Spell{ basespell, 0, true };
+    }
+
+    double const mapTick = Measure(SELF_CHECK_BENCH_TICKS, [&]()
+    {
+        for (uint32 time = 0; time < SELF_CHECK_BENCH_TICKS; ++time)
+        {
+            for (uint32 basespell : basespells)
+            {
+                auto itr = spellMap.find(basespell);
+
+                if (itr != spellMap.end() && itr->second->enabled && itr->second->readyTime <= time)
+                {
+                    sink += spellMap.find(basespell)->second->spellId;
+                }
+            }
+
+            if (!(time % 8))
+            {
+                spellMap.find(basespells[time % SELF_CHECK_BENCH_SPELLS])->second->readyTime = time + 1500;
+            }
+        }
+    });
+
+    for (auto const& pair : spellMap)
+    {
+        delete pair.second;
+    }
+
+    std::vector<Spell> book;
+    std::vector<SpellIndex> index;
+
+    for (uint32 slot = 0; slot < SELF_CHECK_BENCH_SPELLS; ++slot)
+    {
+        book.push_back({ basespells[slot], 0, true });
+        index.push_back({ basespells[slot], slot });
+    }
+
+    double const slotTick = Measure(SELF_CHECK_BENCH_TICKS, [&]()
+    {
+        for (uint32 time = 0; time < SELF_CHECK_BENCH_TICKS; ++time)
+        {
+            for (uint32 slot = 0; slot < SELF_CHECK_BENCH_SPELLS; ++slot)
+            {
+                if (book[slot].enabled && book[slot].readyTime <= time)
+                {
+                    sink += book[slot].spellId;
+                }
+            }
+
+            if (!(time % 8))
+            {
+                book[time % SELF_CHECK_BENCH_SPELLS].readyTime = time + 1500;
+            }
+        }
+    });
+
+    auto findSlot = [&index](uint32 basespell) -> int32
+    {
+        auto itr = std::lower_bound(index.begin(), index.end(), basespell,
+            [](SpellIndex const& entry, uint32 spell) { return entry.basespell < spell; });
+
+        return itr != index.end() && itr->basespell == basespell ? int32(itr->slot) : -1;
+    };
+
+    for (Spell& spell : book)
+    {
+        spell.readyTime = 0;
+    }
+
+    double const idTick = Measure(SELF_CHECK_BENCH_TICKS, [&]()
+    {
+        for (uint32 time = 0; time < SELF_CHECK_BENCH_TICKS; ++time)
+        {
+            for (uint32 basespell : basespells)
+            {
+                int32 slot = findSlot(basespell);
+
+                if (slot >= 0 && book[slot].enabled && book[slot].readyTime <= time)
+                {
+                    sink += book[findSlot(basespell)].spellId;
+                }
+            }
+
+            if (!(time % 8))
+            {
+                book[findSlot(basespells[time % SELF_CHECK_BENCH_SPELLS])].readyTime = time + 1500;
+            }
+        }
+    });
+
+    benchSink += sink;
+
+    lines.push_back(Acore::StringFormatFmt(
+        "spell book bench {} spells (ns/tick): unordered_map {:.1f}, flat by slot {:.1f}, flat by spell id {:.1f}",
+        SELF_CHECK_BENCH_SPELLS, mapTick, slotTick, idTick));
+
+    return true;
+}
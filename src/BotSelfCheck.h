@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_SELF_CHECK_H
+#define _BOT_SELF_CHECK_H
+
+#include "Define.h"
+
+#include <string>
+#include <vector>
+
+// Startup self checks (NpcBots.SelfCheck.Enable).
+// Each check appends its report to lines and returns false when it failed.
+// Run() logs the reports to the npcbots log, a failed check as an error.
+class BotSelfCheck
+{
+public:
+    static void Run();
+
+private:
+    // insert / lookup / iterate at 100, 1k and 10k bots,
+    // against the std::map of heap entries the registry used to be
+    static bool BenchRegistry(std::vector<std::string>& lines);
+
+    // combat tick spell checks on the flat spell book (by slot and by spell id),
+    // against the unordered_map of heap spells it replaced
+    static bool BenchSpellBook(std::vector<std::string>& lines);
+};
+
+#endif // _BOT_SELF_CHECK_H
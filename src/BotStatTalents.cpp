@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotStatTalents.h"
+#include "BotCommon.h"
+
+namespace
+{
+
+// highest level with its own row in the folded table, higher levels use this one
+constexpr uint8 TALENT_MAX_LEVEL = 83;
+constexpr uint8 TALENT_ANY_LEVEL = 0xFF;
+// spec 0 matches every spec of the class
+constexpr uint8 TALENT_ANY_SPEC = 0;
+
+// the talent tables only cover the primary stats (BOT_STAT_MOD_AGILITY .. BOT_STAT_MOD_STAMINA)
+constexpr uint8 TALENT_STAT_FIRST = BOT_STAT_MOD_AGILITY;
+constexpr uint8 TALENT_STAT_COUNT = BOT_STAT_MOD_STAMINA - BOT_STAT_MOD_AGILITY + 1;
+
+// a class has 3 talent specs, slot 3 is used for BOT_SPEC_DEFAULT or a spec of another class
+constexpr uint8 TALENT_SPEC_SLOTS = 4;
+constexpr uint8 TALENT_CLASS_COUNT = BOT_CLASS_DRUID + 1;
+
+struct BotTalentStatMod
+{
+    uint8 botClass;
+    uint8 spec;
+    uint8 stat;
+    uint8 minLevel;
+    uint8 maxLevel;
+    float multiplier;
+};
+
+struct BotStanceStatMod
+{
+    uint8 botClass;
+    uint8 spec;
+    uint8 stance;
+    uint8 stat;
+    uint8 minLevel;
+    float multiplier;
+};
+
+constexpr BotTalentStatMod BotTalentStatMods[] =
+{
+    // strength
+    //Vitality, Strength of Arms
+    { BOT_CLASS_WARRIOR,        BOT_SPEC_WARRIOR_PROTECTION,    BOT_STAT_MOD_STRENGTH,  45, TALENT_ANY_LEVEL, 1.06f },
+    { BOT_CLASS_WARRIOR,        BOT_SPEC_WARRIOR_ARMS,          BOT_STAT_MOD_STRENGTH,  40, TALENT_ANY_LEVEL, 1.04f },
+    //Improved Berserker Stance part 1 (all stances)
+    { BOT_CLASS_WARRIOR,        BOT_SPEC_WARRIOR_FURY,          BOT_STAT_MOD_STRENGTH,  45, TALENT_ANY_LEVEL, 1.2f },
+    //Divine Strength
+    { BOT_CLASS_PALADIN,        TALENT_ANY_SPEC,                BOT_STAT_MOD_STRENGTH,  10, TALENT_ANY_LEVEL, 1.15f },
+    //Ravenous Dead part 1, Endless Winter part 1, Veteran of the Third War part 1, Abomination's might part 2
+    { BOT_CLASS_DEATH_KNIGHT,   TALENT_ANY_SPEC,                BOT_STAT_MOD_STRENGTH,  56, TALENT_ANY_LEVEL, 1.03f },
+    { BOT_CLASS_DEATH_KNIGHT,   TALENT_ANY_SPEC,                BOT_STAT_MOD_STRENGTH,  58, TALENT_ANY_LEVEL, 1.04f },
+    { BOT_CLASS_DEATH_KNIGHT,   BOT_SPEC_DK_BLOOD,              BOT_STAT_MOD_STRENGTH,  59, TALENT_ANY_LEVEL, 1.06f },
+    { BOT_CLASS_DEATH_KNIGHT,   BOT_SPEC_DK_BLOOD,              BOT_STAT_MOD_STRENGTH,  60, TALENT_ANY_LEVEL, 1.02f },
+    //Survival of the Fittest (feral), Improved Mark of the Wild (others)
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_STRENGTH,  10, 34,               1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_STRENGTH,  35, TALENT_ANY_LEVEL, 1.08f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_BALANCE,         BOT_STAT_MOD_STRENGTH,  10, TALENT_ANY_LEVEL, 1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_RESTORATION,     BOT_STAT_MOD_STRENGTH,  10, TALENT_ANY_LEVEL, 1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DEFAULT,               BOT_STAT_MOD_STRENGTH,  10, TALENT_ANY_LEVEL, 1.02f },
+
+    // agility
+    //Combat Experience, Lightning Reflexes
+    { BOT_CLASS_HUNTER,         BOT_SPEC_HUNTER_MARKSMANSHIP,   BOT_STAT_MOD_AGILITY,   35, TALENT_ANY_LEVEL, 1.04f },
+    { BOT_CLASS_HUNTER,         BOT_SPEC_HUNTER_SURVIVAL,       BOT_STAT_MOD_AGILITY,   35, TALENT_ANY_LEVEL, 1.15f },
+    //Hunting Party
+    { BOT_CLASS_HUNTER,         BOT_SPEC_HUNTER_SURVIVAL,       BOT_STAT_MOD_AGILITY,   35, TALENT_ANY_LEVEL, 1.03f },
+    //Sinister Calling
+    { BOT_CLASS_ROGUE,          BOT_SPEC_ROGUE_SUBTLETY,        BOT_STAT_MOD_AGILITY,   45, TALENT_ANY_LEVEL, 1.15f },
+    //Survival of the Fittest (feral), Improved Mark of the Wild (others)
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_AGILITY,   10, 34,               1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_AGILITY,   35, TALENT_ANY_LEVEL, 1.08f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_BALANCE,         BOT_STAT_MOD_AGILITY,   10, TALENT_ANY_LEVEL, 1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_RESTORATION,     BOT_STAT_MOD_AGILITY,   10, TALENT_ANY_LEVEL, 1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DEFAULT,               BOT_STAT_MOD_AGILITY,   10, TALENT_ANY_LEVEL, 1.02f },
+
+    // stamina
+    //Vitality, Strength of Arms
+    { BOT_CLASS_WARRIOR,        BOT_SPEC_WARRIOR_PROTECTION,    BOT_STAT_MOD_STAMINA,   45, TALENT_ANY_LEVEL, 1.09f },
+    { BOT_CLASS_WARRIOR,        BOT_SPEC_WARRIOR_ARMS,          BOT_STAT_MOD_STAMINA,   40, TALENT_ANY_LEVEL, 1.04f },
+    //Combat Expertise, Sacred Duty
+    { BOT_CLASS_PALADIN,        BOT_SPEC_PALADIN_PROTECTION,    BOT_STAT_MOD_STAMINA,   45, TALENT_ANY_LEVEL, 1.06f },
+    { BOT_CLASS_PALADIN,        BOT_SPEC_PALADIN_PROTECTION,    BOT_STAT_MOD_STAMINA,   35, TALENT_ANY_LEVEL, 1.04f },
+    //Survivalist
+    { BOT_CLASS_HUNTER,         TALENT_ANY_SPEC,                BOT_STAT_MOD_STAMINA,   20, TALENT_ANY_LEVEL, 1.1f },
+    //Lightning Reflexes part 2
+    { BOT_CLASS_ROGUE,          BOT_SPEC_ROGUE_COMBAT,          BOT_STAT_MOD_STAMINA,   25, TALENT_ANY_LEVEL, 1.04f },
+    //Improved Power Word: Shield
+    { BOT_CLASS_PRIEST,         TALENT_ANY_SPEC,                BOT_STAT_MOD_STAMINA,   15, TALENT_ANY_LEVEL, 1.04f },
+    //Veteran of the Third War part 2
+    { BOT_CLASS_DEATH_KNIGHT,   BOT_SPEC_DK_BLOOD,              BOT_STAT_MOD_STAMINA,   59, TALENT_ANY_LEVEL, 1.03f },
+    //Demonic Embrace
+    { BOT_CLASS_WARLOCK,        TALENT_ANY_SPEC,                BOT_STAT_MOD_STAMINA,   10, TALENT_ANY_LEVEL, 1.1f },
+    //Survival of the Fittest, Improved Mark of the Wild
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_STAMINA,   35, TALENT_ANY_LEVEL, 1.06f },
+    { BOT_CLASS_DRUID,          TALENT_ANY_SPEC,                BOT_STAT_MOD_STAMINA,   10, TALENT_ANY_LEVEL, 1.02f },
+
+    // intellect
+    //Divine Intellect
+    { BOT_CLASS_PALADIN,        TALENT_ANY_SPEC,                BOT_STAT_MOD_INTELLECT, 15, TALENT_ANY_LEVEL, 1.1f },
+    //Combat Experience
+    { BOT_CLASS_HUNTER,         BOT_SPEC_HUNTER_MARKSMANSHIP,   BOT_STAT_MOD_INTELLECT, 35, TALENT_ANY_LEVEL, 1.04f },
+    //Arcane Mind
+    { BOT_CLASS_MAGE,           BOT_SPEC_MAGE_ARCANE,           BOT_STAT_MOD_INTELLECT, 30, TALENT_ANY_LEVEL, 1.15f },
+    //Mental Strength
+    { BOT_CLASS_PRIEST,         BOT_SPEC_PRIEST_DISCIPLINE,     BOT_STAT_MOD_INTELLECT, 30, TALENT_ANY_LEVEL, 1.15f },
+    //Ancestral Knowledge
+    { BOT_CLASS_SHAMAN,         TALENT_ANY_SPEC,                BOT_STAT_MOD_INTELLECT, 10, TALENT_ANY_LEVEL, 1.1f },
+    //Survival of the Fittest (feral), Improved Mark of the Wild (others)
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_INTELLECT, 10, 34,               1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_INTELLECT, 35, TALENT_ANY_LEVEL, 1.08f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_BALANCE,         BOT_STAT_MOD_INTELLECT, 10, TALENT_ANY_LEVEL, 1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_RESTORATION,     BOT_STAT_MOD_INTELLECT, 10, TALENT_ANY_LEVEL, 1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DEFAULT,               BOT_STAT_MOD_INTELLECT, 10, TALENT_ANY_LEVEL, 1.02f },
+    //Heart of the Wild: ferals only (tanks included)
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_INTELLECT, 35, TALENT_ANY_LEVEL, 1.2f },
+
+    // spirit
+    //Spirit of Redemption part 1
+    { BOT_CLASS_PRIEST,         BOT_SPEC_PRIEST_HOLY,           BOT_STAT_MOD_SPIRIT,    30, TALENT_ANY_LEVEL, 1.05f },
+    //Enlightenment part 1
+    { BOT_CLASS_PRIEST,         BOT_SPEC_PRIEST_DISCIPLINE,     BOT_STAT_MOD_SPIRIT,    35, TALENT_ANY_LEVEL, 1.06f },
+    //Student of the Mind
+    { BOT_CLASS_MAGE,           TALENT_ANY_SPEC,                BOT_STAT_MOD_SPIRIT,    20, TALENT_ANY_LEVEL, 1.1f },
+    //Survival of the Fittest (feral), Improved Mark of the Wild (others)
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_SPIRIT,    10, 34,               1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,           BOT_STAT_MOD_SPIRIT,    35, TALENT_ANY_LEVEL, 1.08f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_BALANCE,         BOT_STAT_MOD_SPIRIT,    10, TALENT_ANY_LEVEL, 1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_RESTORATION,     BOT_STAT_MOD_SPIRIT,    10, TALENT_ANY_LEVEL, 1.02f },
+    { BOT_CLASS_DRUID,          BOT_SPEC_DEFAULT,               BOT_STAT_MOD_SPIRIT,    10, TALENT_ANY_LEVEL, 1.02f },
+    //Living Spirit
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_RESTORATION,     BOT_STAT_MOD_SPIRIT,    40, TALENT_ANY_LEVEL, 1.15f },
+};
+
+// few rows, scanned at runtime since the stance is not part of the folded table key
+constexpr BotStanceStatMod BotStanceStatMods[] =
+{
+    //Frost Presence passive / Improved Frost Presence
+    { BOT_CLASS_DEATH_KNIGHT,   BOT_SPEC_DK_FROST,      DEATH_KNIGHT_FROST_PRESENCE,    BOT_STAT_MOD_STRENGTH,  61, 1.08f },
+    //Bear form: stamina bonus base 25%
+    { BOT_CLASS_DRUID,          TALENT_ANY_SPEC,        DRUID_BEAR_FORM,                BOT_STAT_MOD_STAMINA,   0,  1.25f },
+    //Heart of the Wild: 10% stam bonus for bear
+    { BOT_CLASS_DRUID,          BOT_SPEC_DRUID_FERAL,   DRUID_BEAR_FORM,                BOT_STAT_MOD_STAMINA,   35, 1.1f },
+    //Furor (Moonkin Form)
+    { BOT_CLASS_DRUID,          TALENT_ANY_SPEC,        DRUID_MOONKIN_FORM,             BOT_STAT_MOD_INTELLECT, 0,  1.1f },
+};
+
+constexpr uint8 GetTalentSpecSlot(uint32 botClass, uint8 spec)
+{
+    uint8 firstSpec = 0;
+
+    switch (botClass)
+    {
+        case BOT_CLASS_WARRIOR:         firstSpec = BOT_SPEC_WARRIOR_ARMS;          break;
+        case BOT_CLASS_PALADIN:         firstSpec = BOT_SPEC_PALADIN_HOLY;          break;
+        case BOT_CLASS_HUNTER:          firstSpec = BOT_SPEC_HUNTER_BEASTMASTERY;   break;
+        case BOT_CLASS_ROGUE:           firstSpec = BOT_SPEC_ROGUE_ASSASINATION;    break;
+        case BOT_CLASS_PRIEST:          firstSpec = BOT_SPEC_PRIEST_DISCIPLINE;     break;
+        case BOT_CLASS_DEATH_KNIGHT:    firstSpec = BOT_SPEC_DK_BLOOD;              break;
+        case BOT_CLASS_SHAMAN:          firstSpec = BOT_SPEC_SHAMAN_ELEMENTAL;      break;
+        case BOT_CLASS_MAGE:            firstSpec = BOT_SPEC_MAGE_ARCANE;           break;
+        case BOT_CLASS_WARLOCK:         firstSpec = BOT_SPEC_WARLOCK_AFFLICTION;    break;
+        case BOT_CLASS_DRUID:           firstSpec = BOT_SPEC_DRUID_BALANCE;         break;
+        default:                                                                    break;
+    }
+
+    if (firstSpec && spec >= firstSpec && spec < firstSpec + 3)
+    {
+        return spec - firstSpec;
+    }
+
+    return TALENT_SPEC_SLOTS - 1;
+}
+
+struct BotTalentStatTable
+{
+    float multiplier[TALENT_CLASS_COUNT][TALENT_SPEC_SLOTS][TALENT_STAT_COUNT][TALENT_MAX_LEVEL + 1];
+};
+
+// folds BotTalentStatMods into one multiplier per (class, spec slot, stat, level)
+constexpr BotTalentStatTable BuildTalentStatTable()
+{
+    BotTalentStatTable table{};
+
+    for (uint8 c = 0; c != TALENT_CLASS_COUNT; ++c)
+    {
+        for (uint8 s = 0; s != TALENT_SPEC_SLOTS; ++s)
+        {
+            for (uint8 t = 0; t != TALENT_STAT_COUNT; ++t)
+            {
+                for (uint8 l = 0; l <= TALENT_MAX_LEVEL; ++l)
+                {
+                    table.multiplier[c][s][t][l] = 1.0f;
+                }
+            }
+        }
+    }
+
+    for (BotTalentStatMod const& mod : BotTalentStatMods)
+    {
+        uint8 const stat = mod.stat - TALENT_STAT_FIRST;
+        uint8 const maxLevel = mod.maxLevel < TALENT_MAX_LEVEL ? mod.maxLevel : TALENT_MAX_LEVEL;
+
+        for (uint8 s = 0; s != TALENT_SPEC_SLOTS; ++s)
+        {
+            if (mod.spec != TALENT_ANY_SPEC && GetTalentSpecSlot(mod.botClass, mod.spec) != s)
+            {
+                continue;
+            }
+
+            for (uint8 l = mod.minLevel; l <= maxLevel; ++l)
+            {
+                table.multiplier[mod.botClass][s][stat][l] *= mod.multiplier;
+            }
+        }
+    }
+
+    return table;
+}
+
+constexpr BotTalentStatTable BotTalentStatMultipliers = BuildTalentStatTable();
+
+}
+
+float GetBotTalentStatMultiplier(uint32 botClass, uint8 spec, uint8 stat, uint8 level)
+{
+    if (botClass >= TALENT_CLASS_COUNT || stat < TALENT_STAT_FIRST || stat >= TALENT_STAT_FIRST + TALENT_STAT_COUNT)
+    {
+        return 1.0f;
+    }
+
+    if (level > TALENT_MAX_LEVEL)
+    {
+        level = TALENT_MAX_LEVEL;
+    }
+
+    return BotTalentStatMultipliers.multiplier[botClass][GetTalentSpecSlot(botClass, spec)][stat - TALENT_STAT_FIRST][level];
+}
+
+float GetBotStanceStatMultiplier(uint32 botClass, uint8 spec, uint8 stance, uint8 stat, uint8 level)
+{
+    float multiplier = 1.0f;
+
+    if (stance == BOT_STANCE_NONE)
+    {
+        return multiplier;
+    }
+
+    for (BotStanceStatMod const& mod : BotStanceStatMods)
+    {
+        if (mod.botClass == botClass && mod.stance == stance && mod.stat == stat && level >= mod.minLevel &&
+            (mod.spec == TALENT_ANY_SPEC || mod.spec == spec))
+        {
+            multiplier *= mod.multiplier;
+        }
+    }
+
+    return multiplier;
+}
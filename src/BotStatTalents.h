@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_STAT_TALENTS_H
+#define _BOT_STAT_TALENTS_H
+
+#include "Define.h"
+
+// Talent (and stance) multipliers of the primary stats, see BotStatTalents.cpp.
+// Both return 1.0f for stats, classes and specs without a modifier.
+
+// combined talent multiplier of (class, spec, stat, level)
+float GetBotTalentStatMultiplier(uint32 botClass, uint8 spec, uint8 stat, uint8 level);
+
+// combined multiplier of the stance / form dependent talents
+float GetBotStanceStatMultiplier(uint32 botClass, uint8 spec, uint8 stance, uint8 stat, uint8 level);
+
+#endif // _BOT_STAT_TALENTS_H
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotTraffic.h"
+#include "BotConfig.h"
+#include "BotMapData.h"
+#include "BotMgr.h"
+#include "Group.h"
+#include "Log.h"
+#include "ObjectAccessor.h"
+#include "Player.h"
+#include "StringFormat.h"
+#include "WorldSession.h"
+
+#include <algorithm>
+
+// bots listed by BuildSummary, highest traffic first
+#define BOT_TRAFFIC_SUMMARY_BOTS 20
+
+void BotTrafficBuffer::Record(BotTrafficType type, ObjectGuid botGUID, ObjectGuid ownerGUID, uint32 packets, uint64 bytes)
+{
+    m_byType[type].packets += packets;
+    m_byType[type].bytes += bytes;
+
+    BotTrafficCounter& bot = m_byBot[botGUID];
+    bot.packets += packets;
+    bot.bytes += bytes;
+
+    if (!ownerGUID.IsEmpty())
+    {
+        BotTrafficCounter& owner = m_byOwner[ownerGUID];
+        owner.packets += packets;
+        owner.bytes += bytes;
+    }
+}
+
+void BotTrafficBuffer::RecordGroupUpdate(Group const* group, ObjectGuid botGUID, ObjectGuid ownerGUID)
+{
+    // SMSG_GROUP_LIST: 41 bytes of group data plus 13 bytes and the name of
+    // every member except the receiver
+    uint64 memberBytes = 0;
+
+    for (Group::MemberSlot const& slot : group->GetMemberSlots())
+    {
+        memberBytes += slot.name.size() + 1 + 12;
+    }
+
+    uint32 packets = 0;
+    uint64 bytes = 0;
+
+    for (GroupReference const* ref = group->GetFirstMember(); ref != nullptr; ref = ref->next())
+    {
+        if (Player const* member = ref->GetSource())
+        {
+            ++packets;
+            bytes += 41 + memberBytes - std::min<uint64>(memberBytes, member->GetName().size() + 1 + 12);
+        }
+    }
+
+    if (packets)
+    {
+        Record(BOT_TRAFFIC_GROUP_LIST, botGUID, ownerGUID, packets, bytes);
+    }
+}
+
+void BotTrafficBuffer::Clear()
+{
+    for (BotTrafficCounter& counter : m_byType)
+    {
+        counter = BotTrafficCounter();
+    }
+
+    m_byBot.clear();
+    m_byOwner.clear();
+}
+
+void BotTrafficMgr::Record(BotTrafficType type, ObjectGuid botGUID, ObjectGuid ownerGUID, uint32 packets, uint64 bytes)
+{
+    lock();
+    m_totals.Record(type, botGUID, ownerGUID, packets, bytes);
+    unlock();
+}
+
+void BotTrafficMgr::RecordGroupUpdate(Group const* group, ObjectGuid botGUID, ObjectGuid ownerGUID)
+{
+    lock();
+    m_totals.RecordGroupUpdate(group, botGUID, ownerGUID);
+    unlock();
+}
+
+void BotTrafficMgr::Merge(BotTrafficBuffer& buffer)
+{
+    if (buffer.m_byBot.empty())
+    {
+        return;
+    }
+
+    lock();
+
+    for (uint32 type = 0; type < BOT_TRAFFIC_MAX; ++type)
+    {
+        m_totals.m_byType[type].packets += buffer.m_byType[type].packets;
+        m_totals.m_byType[type].bytes += buffer.m_byType[type].bytes;
+    }
+
+    for (auto const& pair : buffer.m_byBot)
+    {
+        BotTrafficCounter& bot = m_totals.m_byBot[pair.first];
+        bot.packets += pair.second.packets;
+        bot.bytes += pair.second.bytes;
+    }
+
+    for (auto const& pair : buffer.m_byOwner)
+    {
+        BotTrafficCounter& owner = m_totals.m_byOwner[pair.first];
+        owner.packets += pair.second.packets;
+        owner.bytes += pair.second.bytes;
+    }
+
+    unlock();
+
+    buffer.Clear();
+}
+
+// owners stay, their totals cover bots they dismissed
+void BotTrafficMgr::Prune()
+{
+    BotsRegistrySnapshotRef snapshot = sBotsRegistry->GetSnapshot();
+
+    lock();
+
+    for (auto itr = m_totals.m_byBot.begin(); itr != m_totals.m_byBot.end();)
+    {
+        if (snapshot->Find(itr->first))
+        {
+            ++itr;
+        }
+        else
+        {
+            itr = m_totals.m_byBot.erase(itr);
+        }
+    }
+
+    unlock();
+}
+
+void BotTrafficMgr::Update(uint32 diff)
+{
+    sBotMapDataMgr->ForEach([this](BotMapData& data)
+    {
+        Merge(data.GetTraffic());
+    });
+
+    m_pruneTimer += diff;
+
+    if (m_pruneTimer >= BOT_TRAFFIC_PRUNE_INTERVAL)
+    {
+        m_pruneTimer = 0;
+        Prune();
+    }
+
+    m_elapsed += diff;
+
+    uint32 interval = sBotConfig->GetTrafficSummaryInterval() * IN_MILLISECONDS;
+
+    if (!interval)
+    {
+        return;
+    }
+
+    m_summaryTimer += diff;
+
+    if (m_summaryTimer < interval)
+    {
+        return;
+    }
+
+    m_summaryTimer = 0;
+
+    std::vector<std::string> lines;
+    BuildSummary(lines);
+
+    for (std::string const& line : lines)
+    {
+        LOG_INFO("npcbots", "{}", line);
+    }
+}
+
+void BotTrafficMgr::BuildSummary(std::vector<std::string>& lines)
+{
+    lock();
+
+    float const seconds = std::max<uint32>(m_elapsed, IN_MILLISECONDS) / float(IN_MILLISECONDS);
+
+    BotTrafficCounter total;
+
+    for (BotTrafficCounter const& counter : m_totals.m_byType)
+    {
+        total.packets += counter.packets;
+        total.bytes += counter.bytes;
+    }
+
+    lines.push_back(Acore::StringFormatFmt(
+        "bot traffic over {:.0f}s: {} packets, {} bytes ({:.1f} bytes/s), {} bots, {} owners",
+        seconds,
+        total.packets,
+        total.bytes,
+        total.bytes / seconds,
+        m_totals.m_byBot.size(),
+        m_totals.m_byOwner.size()));
+
+    for (uint32 type = 0; type < BOT_TRAFFIC_MAX; ++type)
+    {
+        BotTrafficCounter const& counter = m_totals.m_byType[type];
+
+        lines.push_back(Acore::StringFormatFmt(
+            "    +-- {}: {} packets, {} bytes ({:.1f} bytes/s)",
+            GetTypeName(BotTrafficType(type)),
+            counter.packets,
+            counter.bytes,
+            counter.bytes / seconds));
+    }
+
+    for (auto const& pair : m_totals.m_byOwner)
+    {
+        Player const* owner = ObjectAccessor::FindPlayer(pair.first);
+
+        lines.push_back(Acore::StringFormatFmt(
+            "    +-- owner {} ({}, account {}): {} packets, {:.1f} bytes/s",
+            pair.first.GetCounter(),
+            owner ? owner->GetName() : "offline",
+            owner ? owner->GetSession()->GetAccountId() : 0,
+            pair.second.packets,
+            pair.second.bytes / seconds));
+    }
+
+    std::vector<std::pair<ObjectGuid, BotTrafficCounter>> bots(m_totals.m_byBot.begin(), m_totals.m_byBot.end());
+    size_t const count = std::min<size_t>(bots.size(), BOT_TRAFFIC_SUMMARY_BOTS);
+
+    std::partial_sort(bots.begin(), bots.begin() + count, bots.end(), [](auto const& a, auto const& b)
+    {
+        return a.second.bytes > b.second.bytes;
+    });
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        lines.push_back(Acore::StringFormatFmt(
+            "    +-- bot {}: {} packets, {:.1f} bytes/s",
+            bots[i].first.ToString(),
+            bots[i].second.packets,
+            bots[i].second.bytes / seconds));
+    }
+
+    unlock();
+}
+
+void BotTrafficMgr::Reset()
+{
+    lock();
+
+    m_totals.Clear();
+    m_elapsed = 0;
+
+    unlock();
+}
+
+char const* BotTrafficMgr::GetTypeName(BotTrafficType type)
+{
+    switch (type)
+    {
+        case BOT_TRAFFIC_PARTY_MEMBER_STATS:    return "SMSG_PARTY_MEMBER_STATS";
+        case BOT_TRAFFIC_GROUP_LIST:            return "SMSG_GROUP_LIST (estimated)";
+        case BOT_TRAFFIC_UPDATE_FIELDS:         return "SMSG_UPDATE_OBJECT regen fields (estimated)";
+        default:                                return "unknown";
+    }
+}
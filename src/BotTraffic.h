@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#ifndef _BOT_TRAFFIC_H
+#define _BOT_TRAFFIC_H
+
+#include "Define.h"
+#include "ObjectGuid.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Group;
+
+enum BotTrafficType
+{
+    BOT_TRAFFIC_PARTY_MEMBER_STATS      = 0,    // SMSG_PARTY_MEMBER_STATS, see BotPartyStatsMgr
+    BOT_TRAFFIC_GROUP_LIST              = 1,    // SMSG_GROUP_LIST from Group::SendUpdate(), estimated size
+    BOT_TRAFFIC_UPDATE_FIELDS           = 2,    // health / power field writes from regen, estimated size
+    BOT_TRAFFIC_MAX
+};
+
+// estimated SMSG_UPDATE_OBJECT bytes per field write (value + mask bit),
+// counted once per write, not per player that can see the bot
+#define BOT_TRAFFIC_UPDATE_FIELD_BYTES 4
+
+// bot counters without a registered bot are dropped this often (ms)
+#define BOT_TRAFFIC_PRUNE_INTERVAL 60000
+
+struct BotTrafficCounter
+{
+    uint64 packets = 0;
+    uint64 bytes = 0;
+};
+
+// Traffic counters by packet type, by bot and by owner.
+// One per map (BotMapData), only touched by the thread updating the map and
+// merged into BotTrafficMgr by the world thread, so recording never locks.
+class BotTrafficBuffer
+{
+    friend class BotTrafficMgr;
+
+public:
+    void Record(BotTrafficType type, ObjectGuid botGUID, ObjectGuid ownerGUID, uint32 packets, uint64 bytes);
+
+    // call before Group::SendUpdate(), estimates the SMSG_GROUP_LIST sent to each online member
+    void RecordGroupUpdate(Group const* group, ObjectGuid botGUID, ObjectGuid ownerGUID);
+
+    // keeps the buckets, the same bots record again next frame
+    void Clear();
+
+private:
+    BotTrafficCounter m_byType[BOT_TRAFFIC_MAX];
+    std::unordered_map<ObjectGuid, BotTrafficCounter> m_byBot;
+    std::unordered_map<ObjectGuid, BotTrafficCounter> m_byOwner;
+};
+
+// Counts what the module sends, by packet type, by bot and by owner.
+// Map threads record into the BotTrafficBuffer of their map, Update() merges
+// them. Record() is for the world thread and bots outside of a map.
+class BotTrafficMgr
+{
+protected:
+    explicit BotTrafficMgr() { }
+
+public:
+    static BotTrafficMgr* instance()
+    {
+        static BotTrafficMgr instance;
+        return &instance;
+    }
+
+public:
+    void Record(BotTrafficType type, ObjectGuid botGUID, ObjectGuid ownerGUID, uint32 packets, uint64 bytes);
+
+    // call before Group::SendUpdate(), estimates the SMSG_GROUP_LIST sent to each online member
+    void RecordGroupUpdate(Group const* group, ObjectGuid botGUID, ObjectGuid ownerGUID);
+
+    // world thread while the maps are idle: merges the map buffers, drops the counters
+    // of unregistered bots and logs the summary every NpcBots.Traffic.SummaryInterval seconds
+    void Update(uint32 diff);
+
+    void BuildSummary(std::vector<std::string>& lines);
+    void Reset();
+
+    static char const* GetTypeName(BotTrafficType type);
+
+private:
+    void Merge(BotTrafficBuffer& buffer);
+    void Prune();
+
+    void lock()
+    {
+        m_lock.lock();
+    }
+
+    void unlock()
+    {
+        m_lock.unlock();
+    }
+
+private:
+    std::mutex m_lock;
+
+    BotTrafficBuffer m_totals;
+
+    // time covered by the counters, world thread
+    uint32 m_elapsed = 0;
+    uint32 m_summaryTimer = 0;
+    uint32 m_pruneTimer = 0;
+};
+
+#define sBotTrafficMgr BotTrafficMgr::instance()
+
+#endif // _BOT_TRAFFIC_H
@@ -21,6 +21,9 @@ void AddNPCBotsScripts()
     new CreatureHookScript();
     new SpellHookScript();
     new MovementHandlerHookScript();
+    new WorldHookScript();
+    new MapHookScript();
+    new CommandHookScript();
 
     //**************
     // bot ai script
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotPathCache.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// recorded follow trace (NPCBOTS_PATH_TRACE): the npcbots log with trace
+// messages on, lookups are the "path cache lookup: <start poly> <end poly> <capabilities>"
+// lines. a generated trace is replayed without one
+#define TRACE_ENV "NPCBOTS_PATH_TRACE"
+#define TRACE_MARKER "path cache lookup: "
+#define TRACE_CAPACITY 256
+
+// generated trace: an owner walking over a grid of polygons, its bots casting
+// at targets out of line of sight every TRACE_TICK ms
+#define TRACE_GRID 64
+#define TRACE_BOTS 5
+#define TRACE_TARGETS 3
+#define TRACE_TICK 500
+#define TRACE_TICKS 20000
+
+namespace
+{
+    uint64 GetPoly(int32 x, int32 y)
+    {
+        return uint64(y) * TRACE_GRID + uint64(x) + 1;
+    }
+
+    Movement::PointsArray GetFakePath(BotPathKey const& key)
+    {
+        Movement::PointsArray path;
+        path.push_back(G3D::Vector3(float(key.startPoly), 0.f, 0.f));
+        path.push_back(G3D::Vector3(0.f, 0.f, 0.f));
+        path.push_back(G3D::Vector3(float(key.endPoly), 0.f, 0.f));
+        return path;
+    }
+
+    struct TraceLookup
+    {
+        uint32 time;
+        BotPathKey key;
+    };
+
+    bool LoadTrace(char const* fileName, std::vector<TraceLookup>& trace)
+    {
+        std::ifstream file(fileName);
+
+        if (!file)
+        {
+            return false;
+        }
+
+        TraceLookup lookup = { 0, { 0, 0, 0 } };
+        std::string line;
+
+        while (std::getline(file, line))
+        {
+            size_t const pos = line.find(TRACE_MARKER);
+
+            if (pos == std::string::npos)
+            {
+                continue;
+            }
+
+            // log lines carry no time, spread the lookups as the generated trace does
+            std::istringstream fields(line.substr(pos + sizeof(TRACE_MARKER) - 1));
+
+            if (fields >> lookup.key.startPoly >> lookup.key.endPoly >> lookup.key.capabilities)
+            {
+                lookup.time += TRACE_TICK / TRACE_BOTS;
+                trace.push_back(lookup);
+            }
+        }
+
+        return !trace.empty();
+    }
+
+    // the bots trail the owner in a wedge: bot i stands i / 2 + 1 polygons behind it
+    void GenerateTrace(std::vector<TraceLookup>& trace)
+    {
+        std::mt19937 rng(1);
+        int32 ownerX = TRACE_GRID / 2;
+        int32 ownerY = TRACE_GRID / 2;
+        std::vector<std::pair<int32, int32>> route(TRACE_BOTS + 1, std::make_pair(ownerX, ownerY));
+
+        for (uint32 tick = 0; tick < TRACE_TICKS; ++tick)
+        {
+            if (rng() % 2)
+            {
+                ownerX = std::max<int32>(0, std::min<int32>(TRACE_GRID - 1, ownerX + int32(rng() % 3) - 1));
+                ownerY = std::max<int32>(0, std::min<int32>(TRACE_GRID - 1, ownerY + int32(rng() % 3) - 1));
+
+                route.insert(route.begin(), std::make_pair(ownerX, ownerY));
+                route.pop_back();
+            }
+
+            // targets stay around the owner for a while
+            int32 const targetX = std::max<int32>(0, std::min<int32>(TRACE_GRID - 1, ownerX + int32(rng() % TRACE_TARGETS) - 1));
+            int32 const targetY = std::min<int32>(TRACE_GRID - 1, ownerY + 2);
+
+            for (uint32 bot = 0; bot < TRACE_BOTS; ++bot)
+            {
+                std::pair<int32, int32> const& botPos = route[bot / 2 + 1];
+
+                TraceLookup lookup;
+                lookup.time = tick * TRACE_TICK + bot;
+                lookup.key.startPoly = GetPoly(botPos.first, botPos.second);
+                lookup.key.endPoly = GetPoly(targetX, targetY);
+                lookup.key.capabilities = BOT_PATH_CAN_WALK | BOT_PATH_CAN_SWIM;
+
+                trace.push_back(lookup);
+            }
+        }
+    }
+}
+
+TEST(BotPathCacheTest, EvictsTheLeastRecentlyUsedPath)
+{
+    BotPathCache cache(nullptr);
+    BotPathKey const first = { 1, 2, BOT_PATH_CAN_WALK };
+    BotPathKey const second = { 3, 4, BOT_PATH_CAN_WALK };
+    BotPathKey const third = { 5, 6, BOT_PATH_CAN_WALK };
+
+    cache.Insert(first, GetFakePath(first), 2);
+    cache.Insert(second, GetFakePath(second), 2);
+
+    // first becomes the most recently used, second goes
+    ASSERT_NE(cache.Find(first), nullptr);
+    cache.Insert(third, GetFakePath(third), 2);
+
+    EXPECT_EQ(cache.GetSize(), 2u);
+    EXPECT_EQ(cache.GetEvictions(), 1u);
+    EXPECT_EQ(cache.Find(second), nullptr);
+    ASSERT_NE(cache.Find(third), nullptr);
+    EXPECT_EQ(cache.Find(third)->back().x, 6.f);
+}
+
+TEST(BotPathCacheTest, KeysIncludeTheCapabilities)
+{
+    BotPathCache cache(nullptr);
+    BotPathKey const walker = { 1, 2, BOT_PATH_CAN_WALK };
+    BotPathKey const swimmer = { 1, 2, BOT_PATH_CAN_WALK | BOT_PATH_CAN_SWIM };
+
+    cache.Insert(walker, GetFakePath(walker), TRACE_CAPACITY);
+
+    EXPECT_EQ(cache.Find(swimmer), nullptr);
+    EXPECT_NE(cache.Find(walker), nullptr);
+    EXPECT_EQ(cache.GetHits(), 1u);
+    EXPECT_EQ(cache.GetMisses(), 1u);
+}
+
+TEST(BotPathCacheTest, ExpiredPathsAreComputedAgain)
+{
+    BotPathCache cache(nullptr);
+    BotPathKey const key = { 1, 2, BOT_PATH_CAN_WALK };
+
+    cache.Insert(key, GetFakePath(key), TRACE_CAPACITY);
+    cache.Update(10000);
+
+    EXPECT_NE(cache.Find(key), nullptr);
+
+    cache.Update(60000);
+
+    EXPECT_EQ(cache.Find(key), nullptr);
+    EXPECT_EQ(cache.GetSize(), 0u);
+    EXPECT_EQ(cache.GetEvictions(), 1u);
+}
+
+// bench: hit rate of a follow trace, a miss is a navmesh path query
+TEST(BotPathCacheTest, FollowTraceReplay)
+{
+    std::vector<TraceLookup> trace;
+    char const* traceName = std::getenv(TRACE_ENV);
+
+    if (!traceName || !LoadTrace(traceName, trace))
+    {
+        traceName = "generated trace";
+        GenerateTrace(trace);
+    }
+
+    BotPathCache cache(nullptr);
+    uint32 time = 0;
+
+    for (TraceLookup const& lookup : trace)
+    {
+        cache.Update(lookup.time - time);
+        time = lookup.time;
+
+        if (!cache.Find(lookup.key))
+        {
+            cache.Insert(lookup.key, GetFakePath(lookup.key), TRACE_CAPACITY);
+        }
+    }
+
+    uint64 const lookups = cache.GetHits() + cache.GetMisses();
+
+    std::printf("%s: %llu lookups, %llu hits, %llu misses (%.1f%% hit rate), %llu evictions\n",
+        traceName,
+        (unsigned long long)lookups,
+        (unsigned long long)cache.GetHits(),
+        (unsigned long long)cache.GetMisses(),
+        lookups ? cache.GetHits() * 100.f / lookups : 0.f,
+        (unsigned long long)cache.GetEvictions());
+
+    RecordProperty("hits", int(cache.GetHits()));
+    RecordProperty("misses", int(cache.GetMisses()));
+
+    EXPECT_EQ(lookups, uint64(trace.size()));
+    EXPECT_GT(cache.GetHits(), 0u);
+}
@@ -0,0 +1,464 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotCommon.h"
+#include "BotStatTalents.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define TALENT_MAX_LEVEL 83
+#define TALENT_TOLERANCE 1e-5f
+
+namespace
+{
+    // the talent switch of BotAI::CalculateTotalBotStat(...) before the talent tables,
+    // applied to a stat value of 1
+    float GetSwitchTalentStatMultiplier(uint32 botClass, uint8 spec, uint8 stance, uint8 stat, uint8 lvl)
+    {
+        float fval = 1.0f;
+
+        switch (stat)
+        {
+            case BOT_STAT_MOD_STRENGTH:
+            {
+                switch (botClass)
+                {
+                    case BOT_CLASS_WARRIOR:
+                    {
+                        if (lvl >= 45 && spec == BOT_SPEC_WARRIOR_PROTECTION)
+                        {
+                            fval *= 1.06f;
+                        }
+
+                        if (lvl >= 40 && spec == BOT_SPEC_WARRIOR_ARMS)
+                        {
+                            fval *= 1.04f;
+                        }
+
+                        if (lvl >= 45 && spec == BOT_SPEC_WARRIOR_FURY)
+                        {
+                            fval *= 1.2f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_PALADIN:
+                    {
+                        if (lvl >= 10)
+                        {
+                            fval *= 1.15f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_DEATH_KNIGHT:
+                    {
+                        if (lvl >= 56)
+                        {
+                            fval *= 1.03f;
+                        }
+
+                        if (lvl >= 58)
+                        {
+                            fval *= 1.04f;
+                        }
+
+                        if (lvl >= 59 && spec == BOT_SPEC_DK_BLOOD)
+                        {
+                            fval *= 1.06f;
+                        }
+
+                        if (lvl >= 60 && spec == BOT_SPEC_DK_BLOOD)
+                        {
+                            fval *= 1.02f;
+                        }
+
+                        if (lvl >= 61 && stance == DEATH_KNIGHT_FROST_PRESENCE && spec == BOT_SPEC_DK_FROST)
+                        {
+                            fval *= 1.08f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_DRUID:
+                    {
+                        if (lvl >= 35 && spec == BOT_SPEC_DRUID_FERAL)
+                        {
+                            fval *= 1.08f;
+                        }
+                        else if (lvl >= 10)
+                        {
+                            fval *= 1.02f;
+                        }
+
+                        break;
+                    }
+                    default:
+                    {
+                        break;
+                    }
+                }
+
+                break;
+            }
+
+            case BOT_STAT_MOD_AGILITY:
+            {
+                switch (botClass)
+                {
+                    case BOT_CLASS_HUNTER:
+                    {
+                        if (lvl >= 35 && spec == BOT_SPEC_HUNTER_MARKSMANSHIP)
+                        {
+                            fval *= 1.04f;
+                        }
+
+                        if (lvl >= 35 && spec == BOT_SPEC_HUNTER_SURVIVAL)
+                        {
+                            fval *= 1.15f;
+                        }
+
+                        if (lvl >= 35 && spec == BOT_SPEC_HUNTER_SURVIVAL)
+                        {
+                            fval *= 1.03f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_ROGUE:
+                    {
+                        if (lvl >= 45 && spec == BOT_SPEC_ROGUE_SUBTLETY)
+                        {
+                            fval *= 1.15f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_DRUID:
+                    {
+                        if (lvl >= 35 && spec == BOT_SPEC_DRUID_FERAL)
+                        {
+                            fval *= 1.08f;
+                        }
+                        else if (lvl >= 10)
+                        {
+                            fval *= 1.02f;
+                        }
+
+                        break;
+                    }
+                    default:
+                    {
+                        break;
+                    }
+                }
+
+                break;
+            }
+
+            case BOT_STAT_MOD_STAMINA:
+            {
+                switch (botClass)
+                {
+                    case BOT_CLASS_WARRIOR:
+                    {
+                        if (lvl >= 45 && spec == BOT_SPEC_WARRIOR_PROTECTION)
+                        {
+                            fval *= 1.09f;
+                        }
+
+                        if (lvl >= 40 && spec == BOT_SPEC_WARRIOR_ARMS)
+                        {
+                            fval *= 1.04f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_PALADIN:
+                    {
+                        if (lvl >= 45 && spec == BOT_SPEC_PALADIN_PROTECTION)
+                        {
+                            fval *= 1.06f;
+                        }
+
+                        if (lvl >= 35 && spec == BOT_SPEC_PALADIN_PROTECTION)
+                        {
+                            fval *= 1.04f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_HUNTER:
+                    {
+                        if (lvl >= 20)
+                        {
+                            fval *= 1.1f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_ROGUE:
+                    {
+                        if (lvl >= 25 && spec == BOT_SPEC_ROGUE_COMBAT)
+                        {
+                            fval *= 1.04f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_PRIEST:
+                    {
+                        if (lvl >= 15)
+                        {
+                            fval *= 1.04f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_DEATH_KNIGHT:
+                    {
+                        if (lvl >= 59 && spec == BOT_SPEC_DK_BLOOD)
+                        {
+                            fval *= 1.03f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_WARLOCK:
+                    {
+                        if (lvl >= 10)
+                        {
+                            fval *= 1.1f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_DRUID:
+                    {
+                        if (stance == DRUID_BEAR_FORM)
+                        {
+                            fval *= 1.25f;
+
+                            if (lvl >= 35 && spec == BOT_SPEC_DRUID_FERAL)
+                            {
+                                fval *= 1.1f;
+                            }
+                        }
+
+                        if (lvl >= 35 && spec == BOT_SPEC_DRUID_FERAL)
+                        {
+                            fval *= 1.06f;
+                        }
+
+                        if (lvl >= 10)
+                        {
+                            fval *= 1.02f;
+                        }
+
+                        break;
+                    }
+                    default:
+                    {
+                        break;
+                    }
+                }
+
+                break;
+            }
+
+            case BOT_STAT_MOD_INTELLECT:
+            {
+                switch (botClass)
+                {
+                    case BOT_CLASS_PALADIN:
+                    {
+                        if (lvl >= 15)
+                        {
+                            fval *= 1.1f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_HUNTER:
+                    {
+                        if (lvl >= 35 && spec == BOT_SPEC_HUNTER_MARKSMANSHIP)
+                        {
+                            fval *= 1.04f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_MAGE:
+                    {
+                        if (lvl >= 30 && spec == BOT_SPEC_MAGE_ARCANE)
+                        {
+                            fval *= 1.15f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_PRIEST:
+                    {
+                        if (lvl >= 30 && spec == BOT_SPEC_PRIEST_DISCIPLINE)
+                        {
+                            fval *= 1.15f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_SHAMAN:
+                    {
+                        if (lvl >= 10)
+                        {
+                            fval *= 1.1f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_DRUID:
+                    {
+                        if (lvl >= 35 && spec == BOT_SPEC_DRUID_FERAL)
+                        {
+                            fval *= 1.08f;
+                        }
+                        else if (lvl >= 10)
+                        {
+                            fval *= 1.02f;
+                        }
+
+                        if (stance == DRUID_MOONKIN_FORM)
+                        {
+                            fval *= 1.1f;
+                        }
+
+                        if (lvl >= 35 && spec == BOT_SPEC_DRUID_FERAL)
+                        {
+                            fval *= 1.2f;
+                        }
+
+                        break;
+                    }
+                    default:
+                    {
+                        break;
+                    }
+                }
+
+                break;
+            }
+
+            case BOT_STAT_MOD_SPIRIT:
+            {
+                switch (botClass)
+                {
+                    case BOT_CLASS_PRIEST:
+                    {
+                        if (lvl >= 30 && spec == BOT_SPEC_PRIEST_HOLY)
+                        {
+                            fval *= 1.05f;
+                        }
+
+                        if (lvl >= 35 && spec == BOT_SPEC_PRIEST_DISCIPLINE)
+                        {
+                            fval *= 1.06f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_MAGE:
+                    {
+                        if (lvl >= 20)
+                        {
+                            fval *= 1.1f;
+                        }
+
+                        break;
+                    }
+                    case BOT_CLASS_DRUID:
+                    {
+                        if (lvl >= 35 && spec == BOT_SPEC_DRUID_FERAL)
+                        {
+                            fval *= 1.08f;
+                        }
+                        else if (lvl >= 10)
+                        {
+                            fval *= 1.02f;
+                        }
+
+                        if (lvl >= 40 && spec == BOT_SPEC_DRUID_RESTORATION)
+                        {
+                            fval *= 1.15f;
+                        }
+
+                        break;
+                    }
+                    default:
+                    {
+                        break;
+                    }
+                }
+
+                break;
+            }
+
+            default:
+            {
+                break;
+            }
+        }
+
+        return fval;
+    }
+}
+
+// the folded talent tables give the multiplier of the talent switch they
+// replaced, for every class, spec, stance, stat and level 1 .. 83
+TEST(BotStatTalentsTest, TablesMatchTheTalentSwitch)
+{
+    std::vector<uint8> stances = { BOT_STANCE_NONE };
+
+    for (uint8 stance = WARRIOR_BATTLE_STANCE; stance <= DRUID_AQUATIC_FORM; ++stance)
+    {
+        stances.push_back(stance);
+    }
+
+    uint32 checks = 0;
+    uint32 mismatches = 0;
+
+    for (uint32 botClass = BOT_CLASS_NONE; botClass < BOT_CLASS_END; ++botClass)
+    {
+        for (uint8 spec = 0; spec <= BOT_SPEC_DEFAULT; ++spec)
+        {
+            for (uint8 stance : stances)
+            {
+                for (uint8 stat = 0; stat < MAX_BOT_ITEM_MOD; ++stat)
+                {
+                    for (uint8 level = 1; level <= TALENT_MAX_LEVEL; ++level)
+                    {
+                        float const expected = GetSwitchTalentStatMultiplier(botClass, spec, stance, stat, level);
+                        float const actual = GetBotTalentStatMultiplier(botClass, spec, stat, level) *
+                            GetBotStanceStatMultiplier(botClass, spec, stance, stat, level);
+
+                        ++checks;
+
+                        // the tables multiply in another order, last bits may differ
+                        if (std::fabs(actual - expected) / expected > TALENT_TOLERANCE && ++mismatches <= 10)
+                        {
+                            ADD_FAILURE() << "class " << botClass << " spec " << uint32(spec) << " stance " << uint32(stance)
+                                << " stat " << uint32(stat) << " level " << uint32(level) << ": " << actual << " instead of " << expected;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    EXPECT_GT(checks, 0u);
+    EXPECT_EQ(mismatches, 0u);
+}
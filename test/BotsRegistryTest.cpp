@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>
+ * Released under GNU AGPL v3
+ * License: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE-AGPL3
+ */
+
+#include "BotCommon.h"
+#include "BotEpoch.h"
+#include "BotMgr.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+// registry stress, run under -fsanitize=thread to check for data races
+#define STRESS_TIME 2000
+#define STRESS_WRITERS 2
+#define STRESS_READERS 4
+#define STRESS_BOTS 512
+#define STRESS_OWNERS 8
+
+class BotsRegistryTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_registry = new BotsRegistry();
+    }
+
+    void TearDown() override
+    {
+        delete m_registry;
+    }
+
+    // stored and compared by the registry, never dereferenced
+    static BotAI* GetFakeAI(ObjectGuid botGUID)
+    {
+        return reinterpret_cast<BotAI*>(uintptr_t(botGUID.GetCounter()) << 4);
+    }
+
+    static ObjectGuid GetFakeOwner(uint32 roll)
+    {
+        return ObjectGuid::Create<HighGuid::Player>(1 + roll % STRESS_OWNERS);
+    }
+
+    static ObjectGuid GetBotGUID(uint32 counter)
+    {
+        return ObjectGuid::Create<HighGuid::Unit>(BOT_DREADLORD, counter);
+    }
+
+    BotHandle Register(ObjectGuid botGUID, ObjectGuid ownerGUID)
+    {
+        return m_registry->RegisterEntry(GetFakeAI(botGUID), botGUID, ownerGUID, BOT_DREADLORD);
+    }
+
+    bool Unregister(ObjectGuid botGUID)
+    {
+        return m_registry->UnregisterEntry(GetFakeAI(botGUID), botGUID);
+    }
+
+    void SetOwner(ObjectGuid botGUID, ObjectGuid ownerGUID)
+    {
+        m_registry->SetEntryOwner(botGUID, ownerGUID);
+    }
+
+    BotsRegistry* m_registry;
+};
+
+TEST_F(BotsRegistryTest, WritesAreVisibleToTheNextRead)
+{
+    ObjectGuid botGUID = GetBotGUID(1);
+    BotHandle handle = Register(botGUID, GetFakeOwner(0));
+
+    EXPECT_EQ(m_registry->ResolveBotAI(handle), GetFakeAI(botGUID));
+    EXPECT_EQ(m_registry->GetBotsCountByOwnerGUID(GetFakeOwner(0)), 1u);
+
+    SetOwner(botGUID, GetFakeOwner(1));
+
+    EXPECT_EQ(m_registry->GetBotsCountByOwnerGUID(GetFakeOwner(0)), 0u);
+    EXPECT_EQ(m_registry->GetBotsCountByOwnerGUID(GetFakeOwner(1)), 1u);
+
+    EXPECT_TRUE(Unregister(botGUID));
+    EXPECT_FALSE(m_registry->IsCurrent(handle));
+    EXPECT_TRUE(m_registry->GetSnapshot()->IsEmpty());
+}
+
+TEST_F(BotsRegistryTest, HandlesGoStaleWhenTheSlotIsReused)
+{
+    ObjectGuid first = GetBotGUID(1);
+    BotHandle handle = Register(first, GetFakeOwner(0));
+
+    EXPECT_TRUE(Unregister(first));
+
+    ObjectGuid second = GetBotGUID(2);
+    BotHandle reused = Register(second, GetFakeOwner(0));
+
+    EXPECT_EQ(reused.GetSlot(), handle.GetSlot());
+    EXPECT_FALSE(m_registry->IsCurrent(handle));
+    EXPECT_EQ(m_registry->ResolveBotAI(reused), GetFakeAI(second));
+}
+
+TEST_F(BotsRegistryTest, SnapshotOutlivesLaterWrites)
+{
+    ObjectGuid botGUID = GetBotGUID(1);
+    Register(botGUID, GetFakeOwner(0));
+
+    {
+        BotsRegistrySnapshotRef snapshot = m_registry->GetSnapshot();
+
+        EXPECT_TRUE(Unregister(botGUID));
+
+        // the pinned snapshot is neither changed nor freed by the write
+        ASSERT_NE(snapshot->Find(botGUID), nullptr);
+        EXPECT_EQ(snapshot->Find(botGUID)->GetBotAI(), GetFakeAI(botGUID));
+    }
+
+    sBotEpoch->Reclaim();
+
+    EXPECT_EQ(m_registry->GetSnapshot()->Find(botGUID), nullptr);
+}
+
+// concurrent Register / Unregister / SetEntryOwner against snapshot readers
+TEST_F(BotsRegistryTest, ConcurrentWritersAndReaders)
+{
+    std::atomic<bool> stop(false);
+    std::atomic<uint64> writes(0);
+    std::atomic<uint64> reads(0);
+    std::atomic<uint64> failures(0);
+    std::vector<std::thread> threads;
+
+    for (uint32 writer = 0; writer < STRESS_WRITERS; ++writer)
+    {
+        threads.emplace_back([this, &stop, &writes, &failures, writer]()
+        {
+            std::mt19937 rng(writer + 1);
+            std::vector<std::pair<ObjectGuid, BotHandle>> live;
+            uint32 counter = writer * 10000000;
+
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                if (live.empty() || (live.size() < STRESS_BOTS && rng() % 3))
+                {
+                    ObjectGuid botGUID = GetBotGUID(++counter);
+                    BotHandle handle = Register(botGUID, GetFakeOwner(rng()));
+
+                    if (m_registry->ResolveBotAI(handle) != GetFakeAI(botGUID))
+                    {
+                        ++failures;
+                    }
+
+                    live.emplace_back(botGUID, handle);
+                }
+                else
+                {
+                    size_t i = rng() % live.size();
+
+                    if (rng() % 4 == 0)
+                    {
+                        SetOwner(live[i].first, GetFakeOwner(rng()));
+                    }
+                    else
+                    {
+                        if (!Unregister(live[i].first) || m_registry->IsCurrent(live[i].second))
+                        {
+                            ++failures;
+                        }
+
+                        live[i] = live.back();
+                        live.pop_back();
+                    }
+                }
+
+                ++writes;
+            }
+
+            for (auto const& bot : live)
+            {
+                Unregister(bot.first);
+            }
+        });
+    }
+
+    for (uint32 reader = 0; reader < STRESS_READERS; ++reader)
+    {
+        threads.emplace_back([this, &stop, &reads, &failures, reader]()
+        {
+            std::mt19937 rng(reader + 100);
+
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                ObjectGuid ownerGUID = GetFakeOwner(rng());
+
+                {
+                    BotsRegistrySnapshotRef snapshot = m_registry->GetSnapshot();
+
+                    for (BotEntry const& entry : snapshot->GetEntries())
+                    {
+                        BotHandle handle = entry.GetHandle();
+
+                        if (entry.GetBotAI() != GetFakeAI(entry.GetBotGUID()) ||
+                            snapshot->Find(entry.GetBotGUID()) != &entry ||
+                            snapshot->FindBySlot(handle.GetSlot(), handle.GetGeneration()) != &entry)
+                        {
+                            ++failures;
+                        }
+                    }
+
+                    if (std::vector<BotEntry const*> const* bots = snapshot->FindByOwner(ownerGUID))
+                    {
+                        for (BotEntry const* entry : *bots)
+                        {
+                            if (entry->GetBotOwnerGUID() != ownerGUID)
+                            {
+                                ++failures;
+                            }
+                        }
+                    }
+                }
+
+                m_registry->ForEachBotOfOwner(ownerGUID, [&failures, ownerGUID](BotEntry const& entry)
+                {
+                    if (entry.GetBotOwnerGUID() != ownerGUID)
+                    {
+                        ++failures;
+                    }
+                });
+
+                ++reads;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(STRESS_TIME));
+    stop.store(true);
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_GT(writes.load(), 0u);
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(failures.load(), 0u);
+    EXPECT_TRUE(m_registry->GetSnapshot()->IsEmpty());
+
+    // no thread is reading anymore, every replaced snapshot can be freed
+    sBotEpoch->Reclaim();
+
+    EXPECT_EQ(sBotEpoch->GetRetiredCount(), 0u);
+}